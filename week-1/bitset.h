@@ -0,0 +1,97 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#if defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// undirected graph as one contiguous bit matrix, one bit per vertex pair:
+// row u is adj[u * words .. (u + 1) * words - 1]
+struct bit_matrix {
+    int n;
+    int words;
+    uint64_t *adj;
+};
+
+static inline bool bit_test(const uint64_t *set, int i) {
+    return set[i / 64] >> (i % 64) & 1;
+}
+
+static inline void bit_set(uint64_t *set, int i) {
+    set[i / 64] |= 1ULL << (i % 64);
+}
+
+// n vertices without edges
+static inline struct bit_matrix *bm_create(int n) {
+    struct bit_matrix *B = malloc(sizeof(struct bit_matrix));
+    B->n = n;
+    B->words = (n + 63) / 64;
+    B->adj = calloc((size_t)n * B->words + 1, sizeof(uint64_t));
+    return B;
+}
+
+static inline void bm_free(struct bit_matrix *B) {
+    free(B->adj);
+    free(B);
+}
+
+// the edge u - v, set in both rows
+static inline void bm_add_edge(struct bit_matrix *B, int u, int v) {
+    bit_set(B->adj + (size_t)u * B->words, v);
+    bit_set(B->adj + (size_t)v * B->words, u);
+}
+
+// visits the unvisited neighbours in a row: computes row & ~visited one
+// word at a time, four words at once with AVX2, so 64 (or 256) possible
+// edges are checked per step and only the words with new vertices are
+// looked at bit by bit. the new vertices are appended to queue[*rear ..]
+static inline void expand_row(const uint64_t *row, uint64_t *visited, int words, int *queue, int *rear) {
+    int w = 0;
+#if defined(__AVX2__)
+    for (; w + 4 <= words; w += 4) {
+        __m256i r = _mm256_loadu_si256((const __m256i *)(row + w));
+        __m256i v = _mm256_loadu_si256((const __m256i *)(visited + w));
+        __m256i fresh = _mm256_andnot_si256(v, r);
+        if (_mm256_testz_si256(fresh, fresh))
+            continue;
+        _mm256_storeu_si256((__m256i *)(visited + w), _mm256_or_si256(v, fresh));
+        uint64_t lanes[4];
+        _mm256_storeu_si256((__m256i *)lanes, fresh);
+        for (int k = 0; k < 4; k++) {
+            for (uint64_t bits = lanes[k]; bits; bits &= bits - 1) {
+                queue[(*rear)++] = (w + k) * 64 + __builtin_ctzll(bits);
+            }
+        }
+    }
+#endif
+    for (; w < words; w++) {
+        uint64_t fresh = row[w] & ~visited[w];
+        if (fresh == 0)
+            continue;
+        visited[w] |= fresh;
+        for (; fresh; fresh &= fresh - 1) {
+            queue[(*rear)++] = w * 64 + __builtin_ctzll(fresh);
+        }
+    }
+}
+
+// breadth-first search from source, which must not be visited yet,
+// expanding whole rows with expand_row(). it stops when the queue is
+// empty or as soon as target is visited, target -1 visits the whole
+// component. queue needs room for n vertices
+static inline void bm_search(const struct bit_matrix *B, int source, int target,
+                             uint64_t *visited, int *queue) {
+    int front = 0;
+    int rear = 0;
+    bit_set(visited, source);
+    queue[rear++] = source;
+    while (front < rear && !(target >= 0 && bit_test(visited, target))) {
+        int u = queue[front++];
+        expand_row(B->adj + (size_t)u * B->words, visited, B->words, queue, &rear);
+    }
+}
+
+#endif /* BITSET_H */
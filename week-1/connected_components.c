@@ -1,15 +1,199 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "../week-5/union_find.h"
+#include "../week-2/dfs.h"
+#include "../week-2/frontier.h"
+#include "bitset.h"
+
+/* neighbours of every vertex linked before the largest component is sampled */
+#define NEIGHBOR_ROUNDS 2
+
+/* vertices sampled to guess the largest component */
+#define SAMPLE_SIZE 1024
+
+/*
+ * graph - undirected graph in CSR form, every edge is stored both ways
+ * @n:     number of vertices
+ * @first: neighbours of u are head[first[u] .. first[u + 1] - 1]
+ * @head:  the other end of each edge
+ */
+struct graph {
+    int n;
+    long long int *first;
+    int *head;
+};
+
+/*
+ * afforest - state shared by the afforest threads
+ * @G:            the graph
+ * @thread_count: number of threads
+ * @split:        thread t handles the vertices split[t] .. split[t + 1] - 1
+ * @comp:         parent of each vertex in the component forest, a root
+ *                is its own parent and is the smallest vertex of its tree
+ * @barrier:      synchronizes the phases
+ * @largest:      the root sampled as the largest component, written by
+ *                thread 0 between two barriers
+ */
+struct afforest {
+    struct graph *G;
+    int thread_count;
+    int *split;
+    _Atomic int *comp;
+    pthread_barrier_t barrier;
+    int largest;
+};
+
+/*
+ * afforest_worker - the thread-local state of an afforest thread
+ * @id: index of the thread
+ * @A:  the shared state
+ */
+struct afforest_worker {
+    int id;
+    struct afforest *A;
+};
 
 int number_of_components(int **adj, int n);
-void dfs(int u, int **adj, int n, int *visited);
+int number_of_components_bitset(const struct bit_matrix *B);
+int number_of_components_stream(int n, int m);
+int number_of_components_sparse(const struct graph *G);
+struct graph *read_graph(int n, int m);
+void free_graph(struct graph *G);
+long long int graph_degree(const void *graph, int u);
+int *connected_components_afforest(struct graph *G, int thread_count);
+void *afforest_thread(void *arg);
+void link_vertices(_Atomic int *comp, int u, int v);
+void compress(_Atomic int *comp, int lo, int hi);
+int sample_largest(_Atomic int *comp, int n);
 
-int main(void)
+/*
+ * usage: ./a.out [--dense | --sparse | --bitset | --stream | --afforest]
+ *                [--labels] [--threads=<t>] [--time] < graph
+ *     --dense        build the adjacency matrix instead of the CSR arrays
+ *     --sparse       read the graph into CSR arrays, the default
+ *     --bitset       store the adjacency matrix as bits, 64 vertices per word
+ *     --stream       merge disjoint sets while the edges are read, O(n) memory
+ *     --afforest     parallel afforest on a CSR graph, for large sparse graphs
+ *     --labels       with --afforest, also print the label of every vertex,
+ *                    the smallest vertex of its component
+ *     --threads=<t>  threads for --afforest (default: number of online cpus)
+ *     --time         print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
 {
+    int bitset = 0;
+    int stream = 0;
+    int afforest = 0;
+    int labels = 0;
+    int print_time = 0;
+    int dense = 0;
+    int thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--dense") == 0) {
+            dense = 1;
+        } else if (strcmp(argv[i], "--sparse") == 0) {
+            dense = 0;
+        } else if (strcmp(argv[i], "--bitset") == 0) {
+            bitset = 1;
+        } else if (strcmp(argv[i], "--stream") == 0) {
+            stream = 1;
+        } else if (strcmp(argv[i], "--afforest") == 0) {
+            afforest = 1;
+        } else if (strcmp(argv[i], "--labels") == 0) {
+            labels = 1;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = 1;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     // read vertice number and number of edges
     int n, m;
     scanf("%d %d", &n, &m);
 
+    struct timespec start, end;
+    int result;
+
+    if (stream) {
+        printf("%d\n", number_of_components_stream(n, m));
+        return 0;
+    }
+
+    if (afforest) {
+        struct graph *G = read_graph(n, m);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        int *label = connected_components_afforest(G, thread_count);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        // the roots are labelled with themselves
+        result = 0;
+        for (int i = 0; i < n; ++i) {
+            if (label[i] == i)
+                result++;
+        }
+        printf("%d\n", result);
+        if (labels) {
+            for (int i = 0; i < n; ++i) {
+                printf(i + 1 < n ? "%d " : "%d\n", label[i] + 1);
+            }
+        }
+        if (print_time) {
+            fprintf(stderr, "%d threads: %.3f ms\n", thread_count,
+                    (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+        }
+        free(label);
+        free_graph(G);
+        return 0;
+    }
+
+    if (bitset) {
+        struct bit_matrix *B = bm_create(n);
+        for (int i = 0; i < m; ++i) {
+            int u, v;
+            scanf("%d %d", &u, &v);
+            bm_add_edge(B, u - 1, v - 1);
+        }
+        printf("%d\n", number_of_components_bitset(B));
+        bm_free(B);
+        return 0;
+    }
+
+    // the CSR graph stores every edge at both ends, 8 bytes per edge plus
+    // an 8 byte offset per vertex, and the matrix takes 4 bytes per vertex
+    // pair. without repeated edges 2m <= n^2 - n, so even a complete graph
+    // is about the same size as the matrix, and the matrix is only built
+    // with --dense
+    if (!dense) {
+        struct graph *G = read_graph(n, m);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        result = number_of_components_sparse(G);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        printf("%d\n", result);
+        if (print_time) {
+            fprintf(stderr, "%.3f ms\n",
+                    (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+        }
+        free_graph(G);
+        return 0;
+    }
+
     // initialize adjacent matrix
     int **adj = malloc(n * sizeof(int *));
     for (int i = 0; i < n; ++i) {
@@ -28,7 +212,14 @@ int main(void)
     }
 
     // print the result
-    printf("%d\n", number_of_components(adj, n));
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    result = number_of_components(adj, n);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d\n", result);
+    if (print_time) {
+        fprintf(stderr, "%.3f ms\n",
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
 
     // free the allocated memory
     for (int i = 0; i < n; ++i) {
@@ -41,41 +232,365 @@ int main(void)
 int number_of_components(int **adj, int n){
     int result = 0;
 
-    // allocate an array for keeping track of visited nodes
-    // by initializing with 0
-    int *visited = malloc(n * sizeof(int));
-    for(int i = 0; i < n; ++i){
-        visited[i] = 0;
-    }
+    // the iterative dfs of dfs.h keeps track of the visited nodes,
+    // its stack is on the heap so long paths do not overflow
+    struct dfs_matrix M = {adj, n};
+    struct dfs_visitor V = {NULL, NULL, NULL, NULL, NULL};
+    struct dfs *D = dfs_create(n, &M, dfs_matrix_neighbor);
 
     // loop over all the nodes 
     for(int i = 0; i < n; ++i){
-        if(!visited[i]){             // if the node hasn't been visited yet
+        if(D->state[i] == DFS_NEW){  // if the node hasn't been visited yet
             result++;                // incement result by one.
-            dfs(i, adj, n, visited); // visit the connected 
+            dfs_visit(D, i, &V);     // visit the connected 
+        }
+    }
+    dfs_free(D);
+    return result;
+}
+
+/**
+ * number_of_components_sparse - number_of_components() on a CSR graph
+ *
+ * @G: the graph
+ *
+ * every unvisited node starts a breadth-first search over its
+ * neighbour range, so each edge is looked at twice and the time and
+ * memory are O(n + m) instead of O(n^2).
+ *
+ * Return: the number of connected components
+ */
+int number_of_components_sparse(const struct graph *G)
+{
+    int n = G->n;
+    char *visited = calloc(n > 0 ? n : 1, 1);
+    int *queue = malloc((n > 0 ? n : 1) * sizeof(int));
+    int result = 0;
+    for (int i = 0; i < n; ++i) {
+        if (visited[i])
+            continue;
+        result++;
+        int front = 0, rear = 0;
+        visited[i] = 1;
+        queue[rear++] = i;
+        while (front < rear) {
+            int u = queue[front++];
+            for (long long int j = G->first[u]; j < G->first[u + 1]; ++j) {
+                int v = G->head[j];
+                if (!visited[v]) {
+                    visited[v] = 1;
+                    queue[rear++] = v;
+                }
+            }
         }
     }
     free(visited);
+    free(queue);
     return result;
 }
 
 /**
- * Recursively visit the connected nodes by using Depth First Search (DFS).
- * Starting from the given node, the function visits all reachable nodes
- * by following the edges of the graph. During the traversal, the function
- * marks the visited visited nodes to avoid repetition.
- *
- * @param u: the current node.
- * @param adj: the adjacency matrix of the graph.
- * @param n: the number of nodes.
- * @param visited: array showing visited nodes.
+ * number_of_components_bitset - number_of_components() on the bit matrix
+ *
+ * @B: the bit matrix
+ *
+ * every unvisited node starts a breadth-first search that expands
+ * whole rows with expand_row().
+ *
+ * Return: the number of connected components
  */
-void dfs(int u, int **adj, int n, int *visited){
-    visited[u] = 1;
-    for(int v = 0; v < n; ++v){
-        if(adj[u][v] && !visited[v]){
-            dfs(v, adj, n, visited);
+int number_of_components_bitset(const struct bit_matrix *B)
+{
+    uint64_t *visited = calloc(B->words + 1, sizeof(uint64_t));
+    int *queue = malloc((B->n > 0 ? B->n : 1) * sizeof(int));
+    int result = 0;
+    for (int i = 0; i < B->n; ++i) {
+        if (bit_test(visited, i))
+            continue;
+        result++;
+        bm_search(B, i, -1, visited, queue);
+    }
+    free(visited);
+    free(queue);
+    return result;
+}
+
+/**
+ * number_of_components_stream - counts the components while reading
+ *
+ * @n: number of nodes
+ * @m: number of edges left in the input
+ *
+ * every node starts as its own component, and each edge read that
+ * joins two different sets merges them and removes one component.
+ * only the disjoint sets are kept, the edges are never stored.
+ *
+ * Return: the number of connected components
+ */
+int number_of_components_stream(int n, int m)
+{
+    struct union_find *U = uf_create(n);
+    int result = n;
+    for (int i = 0; i < m; ++i) {
+        int u, v;
+        scanf("%d %d", &u, &v);
+        if (uf_union(U, u - 1, v - 1))
+            result--;
+    }
+    uf_free(U);
+    return result;
+}
+
+/**
+ * read_graph - reads the edges into a CSR graph
+ *
+ * @n: number of vertices
+ * @m: number of edges left in the input
+ *
+ * Return: the graph, each edge stored once in the list of either end
+ */
+struct graph *read_graph(int n, int m)
+{
+    struct graph *G = malloc(sizeof(struct graph));
+    G->n = n;
+    G->first = calloc(n + 2, sizeof(long long int));
+    G->head = malloc(((size_t)2 * m + 1) * sizeof(int));
+
+    int *tail = malloc(((size_t)2 * m + 1) * sizeof(int));
+    for (int i = 0; i < m; ++i) {
+        int u, v;
+        scanf("%d %d", &u, &v);
+        tail[2 * i] = u - 1;
+        tail[2 * i + 1] = v - 1;
+        G->first[u + 1]++;
+        G->first[v + 1]++;
+    }
+
+    // first[u + 1] is the next free position of u while filling
+    for (int u = 0; u < n; ++u) {
+        G->first[u + 1] += G->first[u];
+    }
+    for (int i = 0; i < m; ++i) {
+        int u = tail[2 * i], v = tail[2 * i + 1];
+        G->head[G->first[u + 1]++] = v;
+        G->head[G->first[v + 1]++] = u;
+    }
+    free(tail);
+    return G;
+}
+
+void free_graph(struct graph *G)
+{
+    free(G->first);
+    free(G->head);
+    free(G);
+}
+
+/**
+ * graph_degree - the number of edges of a vertex
+ *
+ * @graph: the graph
+ * @u: the vertex
+ *
+ * Return: the degree, for split_by_edges()
+ */
+long long int graph_degree(const void *graph, int u)
+{
+    const struct graph *G = graph;
+    return G->first[u + 1] - G->first[u];
+}
+
+/**
+ * connected_components_afforest - labels the components on threads
+ *
+ * @G: the graph
+ * @thread_count: number of threads
+ *
+ * afforest (Sutton, Ben-Nun and Barak, 2018): every vertex starts as
+ * its own tree and edges hook the root of the larger vertex under the
+ * smaller one with a compare-and-swap, so no locks are needed and a
+ * root is always the smallest vertex of its tree. only the first
+ * NEIGHBOR_ROUNDS neighbours of every vertex are linked at first,
+ * which is usually enough to build the giant component. it is then
+ * found by sampling, and its vertices skip their remaining edges,
+ * the other end of such an edge links it from its side if needed.
+ * pointer jumping flattens the trees after every phase.
+ *
+ * Return: the label of every vertex, the smallest vertex of its
+ *         component (0-based)
+ */
+int *connected_components_afforest(struct graph *G, int thread_count)
+{
+    struct afforest A;
+    A.G = G;
+    A.thread_count = thread_count;
+    A.split = malloc((thread_count + 1) * sizeof(int));
+    A.comp = malloc((G->n > 0 ? G->n : 1) * sizeof(_Atomic int));
+    pthread_barrier_init(&A.barrier, NULL, thread_count);
+    for (int v = 0; v < G->n; ++v) {
+        atomic_init(&A.comp[v], v);
+    }
+
+    split_by_edges(A.split, thread_count, G->n, G->first[G->n], G, graph_degree);
+
+    struct afforest_worker *workers = malloc(thread_count * sizeof(struct afforest_worker));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 0; t < thread_count; ++t) {
+        workers[t].id = t;
+        workers[t].A = &A;
+    }
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, afforest_thread, &workers[t]);
+    }
+    afforest_thread(&workers[0]);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    int *label = malloc((G->n > 0 ? G->n : 1) * sizeof(int));
+    for (int v = 0; v < G->n; ++v) {
+        label[v] = atomic_load(&A.comp[v]);
+    }
+
+    pthread_barrier_destroy(&A.barrier);
+    free(threads);
+    free(workers);
+    free(A.split);
+    free(A.comp);
+    return label;
+}
+
+/**
+ * afforest_thread - the phases run by every afforest thread
+ *
+ * @arg: the worker
+ *
+ * Return: NULL
+ */
+void *afforest_thread(void *arg)
+{
+    struct afforest_worker *W = arg;
+    struct afforest *A = W->A;
+    struct graph *G = A->G;
+    int lo = A->split[W->id], hi = A->split[W->id + 1];
+
+    // link a few neighbours of every vertex
+    for (int r = 0; r < NEIGHBOR_ROUNDS; ++r) {
+        for (int u = lo; u < hi; ++u) {
+            if (G->first[u] + r < G->first[u + 1])
+                link_vertices(A->comp, u, G->head[G->first[u] + r]);
+        }
+        pthread_barrier_wait(&A->barrier);
+        compress(A->comp, lo, hi);
+        pthread_barrier_wait(&A->barrier);
+    }
+
+    if (W->id == 0)
+        A->largest = sample_largest(A->comp, G->n);
+    pthread_barrier_wait(&A->barrier);
+
+    // link the remaining neighbours of the vertices outside of it
+    int largest = A->largest;
+    for (int u = lo; u < hi; ++u) {
+        if (atomic_load_explicit(&A->comp[u], memory_order_relaxed) == largest)
+            continue;
+        for (long long int j = G->first[u] + NEIGHBOR_ROUNDS; j < G->first[u + 1]; ++j) {
+            link_vertices(A->comp, u, G->head[j]);
         }
     }
+    pthread_barrier_wait(&A->barrier);
+    compress(A->comp, lo, hi);
+    return NULL;
 }
 
+/**
+ * link_vertices - merges the trees of u and v
+ *
+ * @comp: the component forest
+ * @u: a vertex
+ * @v: a vertex
+ *
+ * hooks the larger of the two roots under the smaller one. if another
+ * thread moved the larger root first, the compare-and-swap fails and
+ * the walk goes on from the new parents until both are in one tree.
+ */
+void link_vertices(_Atomic int *comp, int u, int v)
+{
+    int p1 = atomic_load_explicit(&comp[u], memory_order_relaxed);
+    int p2 = atomic_load_explicit(&comp[v], memory_order_relaxed);
+    while (p1 != p2) {
+        int high = p1 > p2 ? p1 : p2;
+        int low = p1 + p2 - high;
+        int p_high = atomic_load_explicit(&comp[high], memory_order_relaxed);
+        if (p_high == low)
+            break;
+        if (p_high == high && atomic_compare_exchange_strong_explicit(&comp[high], &p_high, low,
+                                                                      memory_order_relaxed,
+                                                                      memory_order_relaxed))
+            break;
+        p1 = atomic_load_explicit(&comp[atomic_load_explicit(&comp[high], memory_order_relaxed)],
+                                  memory_order_relaxed);
+        p2 = atomic_load_explicit(&comp[low], memory_order_relaxed);
+    }
+}
+
+/**
+ * compress - pointer jumping, links the vertices lo .. hi - 1 to their roots
+ *
+ * @comp: the component forest
+ * @lo: first vertex
+ * @hi: one past the last vertex
+ */
+void compress(_Atomic int *comp, int lo, int hi)
+{
+    for (int v = lo; v < hi; ++v) {
+        int p = atomic_load_explicit(&comp[v], memory_order_relaxed);
+        int gp = atomic_load_explicit(&comp[p], memory_order_relaxed);
+        while (p != gp) {
+            p = gp;
+            gp = atomic_load_explicit(&comp[p], memory_order_relaxed);
+        }
+        atomic_store_explicit(&comp[v], p, memory_order_relaxed);
+    }
+}
+
+static int compare_ints(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
+
+/**
+ * sample_largest - guesses the largest component
+ *
+ * @comp: the component forest, compressed
+ * @n: number of vertices
+ *
+ * Return: the most frequent root among SAMPLE_SIZE vertices picked
+ *         by a fixed pseudo-random sequence
+ */
+int sample_largest(_Atomic int *comp, int n)
+{
+    if (n == 0)
+        return -1;
+    int samples[SAMPLE_SIZE];
+    uint64_t x = 88172645463325252ULL;
+    for (int i = 0; i < SAMPLE_SIZE; ++i) {
+        // xorshift64
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        samples[i] = atomic_load_explicit(&comp[x % n], memory_order_relaxed);
+    }
+    qsort(samples, SAMPLE_SIZE, sizeof(int), compare_ints);
+
+    int best = samples[0], best_count = 0;
+    for (int i = 0, j; i < SAMPLE_SIZE; i = j) {
+        for (j = i; j < SAMPLE_SIZE && samples[j] == samples[i]; ++j);
+        if (j - i > best_count) {
+            best = samples[i];
+            best_count = j - i;
+        }
+    }
+    return best;
+}
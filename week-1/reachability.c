@@ -1,13 +1,51 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "../week-5/union_find.h"
+#include "bitset.h"
 
 int reach(int **adj, int n, int x, int y);
+int reach_bitset(const struct bit_matrix *B, int x, int y);
+int reach_sparse(const int *data, int n, int m, int x, int y);
+void reach_batch(int n, int m);
+
+/*
+ * usage: ./a.out [--dense | --sparse | --bitset | --batch] < graph
+ *     --dense   build the adjacency matrix instead of the CSR arrays
+ *     --sparse  build the CSR arrays, the default
+ *     --bitset  store the adjacency matrix as bits, 64 vertices per word
+ *     --batch   read "x y" queries until the end of the input and answer
+ *               each one on its own line
+ */
+int main(int argc, char *argv[]) {
+    int bitset = 0;
+    int batch = 0;
+    int dense = 0;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--dense") == 0) {
+            dense = 1;
+        } else if (strcmp(argv[i], "--sparse") == 0) {
+            dense = 0;
+        } else if (strcmp(argv[i], "--bitset") == 0) {
+            bitset = 1;
+        } else if (strcmp(argv[i], "--batch") == 0) {
+            batch = 1;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
 
-int main() {
     // read input values
     int n, m;
     scanf("%d %d", &n, &m);
     
+    if (batch) {
+        reach_batch(n, m);
+        return 0;
+    }
+
     // read edge data
     int *data = malloc((2 * m + 2) * sizeof(int));
     for (int i = 0; i < 2 * m + 2; i++) {
@@ -22,6 +60,27 @@ int main() {
     x -= 1;
     y -= 1;
     
+    if (bitset) {
+        struct bit_matrix *B = bm_create(n);
+        for (int i = 0; i < 2 * m; i += 2) {
+            bm_add_edge(B, data[i] - 1, data[i + 1] - 1);
+        }
+        printf("%d\n", reach_bitset(B, x, y));
+        bm_free(B);
+        free(data);
+        return 0;
+    }
+
+    // the CSR arrays store every edge at both ends, 8 bytes per edge plus
+    // 4 per vertex, and the matrix takes 4 bytes per vertex pair. without
+    // repeated edges 2m <= n^2 - n, so the arrays are never the larger
+    // one, and the matrix is only built with --dense
+    if (!dense) {
+        printf("%d\n", reach_sparse(data, n, m, x, y));
+        free(data);
+        return 0;
+    }
+
     // create adjacency matrix
     int **adj = malloc(n * sizeof(int *));
     for (int i = 0; i < n; i++) {
@@ -94,3 +153,112 @@ int reach(int** adj, int n, int x, int y) {
     return result;
 }
 
+/**
+ * reach_bitset - reach() on the bit-packed adjacency matrix
+ *
+ * @B: the bit matrix
+ * @x: the start vertex
+ * @y: the target vertex
+ *
+ * Return: 1 if y is reachable from x, 0 otherwise
+ */
+int reach_bitset(const struct bit_matrix *B, int x, int y)
+{
+    uint64_t *visited = calloc(B->words + 1, sizeof(uint64_t));
+    int *queue = malloc(B->n * sizeof(int));
+
+    // stop as soon as the target vertex is visited
+    bm_search(B, x, y, visited, queue);
+
+    int result = bit_test(visited, y);
+    free(visited);
+    free(queue);
+    return result;
+}
+
+/**
+ * reach_sparse - reach() on adjacency lists in CSR arrays
+ *
+ * @data: the m edges "a b" followed by x and y, 1-based
+ * @n: number of vertices
+ * @m: number of edges
+ * @x: the start vertex
+ * @y: the target vertex
+ *
+ * every edge is stored in both directions, the neighbours of u are
+ * head[first[u] .. first[u + 1] - 1]. the search looks at each edge
+ * at most twice instead of scanning n matrix entries per vertex, so
+ * time and memory are O(n + m).
+ *
+ * Return: 1 if y is reachable from x, 0 otherwise
+ */
+int reach_sparse(const int *data, int n, int m, int x, int y)
+{
+    // count the degrees, then place every edge at both endpoints
+    int *first = calloc(n + 2, sizeof(int));
+    int *head = malloc((2 * m + 1) * sizeof(int));
+    for (int i = 0; i < 2 * m; i++) {
+        first[data[i] + 1]++;
+    }
+    for (int u = 0; u < n; u++) {
+        first[u + 2] += first[u + 1];
+    }
+    // first[u + 1] is the next free position of u while filling
+    for (int i = 0; i < 2 * m; i += 2) {
+        head[first[data[i]]++] = data[i + 1] - 1;
+        head[first[data[i + 1]]++] = data[i] - 1;
+    }
+
+    char *visited = calloc(n, 1);
+    int *queue = malloc(n * sizeof(int));
+    int front = 0;
+    int rear = 0;
+    visited[x] = 1;
+    queue[rear++] = x;
+
+    // stop as soon as the target vertex is visited
+    while (front < rear && !visited[y]) {
+        int u = queue[front++];
+        for (int j = first[u]; j < first[u + 1]; j++) {
+            int v = head[j];
+            if (!visited[v]) {
+                visited[v] = 1;
+                queue[rear++] = v;
+            }
+        }
+    }
+
+    int result = visited[y];
+    free(first);
+    free(head);
+    free(visited);
+    free(queue);
+    return result;
+}
+
+/**
+ * reach_batch - answers many reachability queries on one graph
+ *
+ * @n: number of vertices
+ * @m: number of edges left in the input
+ *
+ * the graph is undirected, so y is reachable from x exactly when both
+ * are in the same connected component. the edges are merged into
+ * disjoint sets as they are read, then every "x y" query until the end
+ * of the input costs two finds.
+ */
+void reach_batch(int n, int m)
+{
+    struct union_find *U = uf_create(n);
+    for (int i = 0; i < m; i++) {
+        int a, b;
+        scanf("%d %d", &a, &b);
+        uf_union(U, a - 1, b - 1);
+    }
+
+    int x, y;
+    while (scanf("%d %d", &x, &y) == 2) {
+        printf("%d\n", uf_find(U, x - 1) == uf_find(U, y - 1));
+    }
+    uf_free(U);
+}
@@ -0,0 +1,40 @@
+#!/bin/bash
+
+# usage: ./bench_connected_components.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 -pthread ../../../week-1/connected_components.c -Wall -lm -o bench.out &&
+
+# n vertices, m random edges
+generate_graph() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            print int(n * rand()) + 1, int(n * rand()) + 1
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+
+# small enough for the adjacency matrix of the sequential dfs, which
+# has to be forced as the default picks the CSR arrays for sparse graphs
+generate_graph 5000 20000 1 > "$tmp_dir/small"
+echo "$(head -n 1 "$tmp_dir/small") graph"
+echo "    dfs: $(./bench.out --dense --time < "$tmp_dir/small" 2>&1 >/dev/null)"
+echo "    sparse: $(./bench.out --sparse --time < "$tmp_dir/small" 2>&1 >/dev/null)"
+for (( t = 1; t <= max_threads; ++t ))
+do
+    echo "    --afforest $(./bench.out --afforest --threads=$t --time < "$tmp_dir/small" 2>&1 >/dev/null)"
+done
+
+generate_graph 2000000 10000000 2 > "$tmp_dir/large"
+echo "$(head -n 1 "$tmp_dir/large") graph, --afforest"
+for (( t = 1; t <= max_threads; ++t ))
+do
+    ./bench.out --afforest --threads=$t --time < "$tmp_dir/large" 2>&1 >/dev/null | sed 's/^/    /'
+done
+
+rm -rf "$tmp_dir" bench.out
@@ -1,15 +1,131 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdbool.h>
 #include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "dfs.h"
+#include "frontier.h"
+
+/*
+ * dynamic_order - a topological order kept up to date under edge insertions
+ * @n:        number of vertices
+ * @out:      the successors of each vertex
+ * @in:       the predecessors of each vertex
+ * @ord:      position of each vertex in the order
+ * @vertex:   the vertex at each position
+ * @mark:     the vertices reached by the searches of the current insertion
+ * @forward:  the vertices reached from the head of the new edge
+ * @backward: the vertices reaching the tail of the new edge
+ * @stack:    the search stack, then the affected vertices in their new order
+ * @pool:     the positions of the affected vertices
+ */
+struct dynamic_order {
+    int n;
+    struct bucket *out;
+    struct bucket *in;
+    int *ord;
+    int *vertex;
+    bool *mark;
+    struct bucket forward;
+    struct bucket backward;
+    int *stack;
+    int *pool;
+};
 
 // function prototypes
-bool acyclic(int **adj_list, int n);
-bool dfs(int v, int **adj_list, int *visited, int *recursion_stack,  int n);
+bool acyclic(const void *graph, dfs_neighbor_fn neighbor, int n);
+bool found_cycle(int u, int v, void *ctx);
+struct dynamic_order *create_order(int n);
+void free_order(struct dynamic_order *O);
+bool insert_edge(struct dynamic_order *O, int x, int y);
+bool search_forward(struct dynamic_order *O, int y, int ub);
+void search_backward(struct dynamic_order *O, int x, int lb);
+void reorder(struct dynamic_order *O);
+int compare_ints(const void *a, const void *b);
+
+/*
+ * usage: ./a.out [--dense | --sparse | --online [--time]] < graph
+ *     --dense   use the adjacency matrix instead of the CSR arrays
+ *     --sparse  use the CSR arrays, the default
+ *     --online  keep a topological order while the edges are read, and
+ *               print for every edge 1 if it would close a cycle, which
+ *               drops it, or 0 if it was added
+ *     --time    print the time of the insertions to stderr
+ */
+int main(int argc, char *argv[]) {
+    bool online = false;
+    bool print_time = false;
+    int dense = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--dense") == 0) {
+            dense = 1;
+        } else if (strcmp(argv[i], "--sparse") == 0) {
+            dense = 0;
+        } else if (strcmp(argv[i], "--online") == 0) {
+            online = true;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
 
-int main() {
     // get #vertices and #edges
     int n, m;
     scanf("%d%d", &n, &m);
+
+    if (online) {
+        struct timespec start, end;
+        struct dynamic_order *O = create_order(n);
+        double total = 0;
+        for (int i = 0; i < m; ++i) {
+            int a, b;
+            scanf("%d %d", &a, &b);
+            clock_gettime(CLOCK_MONOTONIC, &start);
+            bool added = insert_edge(O, a - 1, b - 1);
+            clock_gettime(CLOCK_MONOTONIC, &end);
+            total += (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6;
+            printf("%d\n", !added);
+        }
+        if (print_time) {
+            fprintf(stderr, "%d insertions: %.3f ms\n", m, total);
+        }
+        free_order(O);
+        return 0;
+    }
+
+    // the CSR arrays take 4 bytes per edge plus 4 per vertex, and the
+    // matrix 4 bytes per vertex pair. without repeated edges m <= n^2 - n,
+    // so the arrays are never the larger one, and the matrix is only
+    // built with --dense
+    if (!dense) {
+        // count the edges of every vertex, then place them
+        int *first = calloc(n + 2, sizeof(int));
+        int *tail = malloc((2 * m + 1) * sizeof(int));
+        int *head = malloc((m + 1) * sizeof(int));
+        for (int i = 0; i < 2 * m; i += 2) {
+            scanf("%d %d", &tail[i], &tail[i + 1]);
+            first[tail[i] + 1]++;
+        }
+        for (int i = 0; i < n; ++i) {
+            first[i + 2] += first[i + 1];
+        }
+        // first[u + 1] is the next free position of u while filling, and
+        // ends up as the start of u + 1
+        for (int i = 0; i < 2 * m; i += 2) {
+            head[first[tail[i]]++] = tail[i + 1] - 1;
+        }
+        free(tail);
+
+        struct dfs_csr C = {first, head};
+        printf("%d\n", acyclic(&C, dfs_csr_neighbor, n));
+        free(first);
+        free(head);
+        return 0;
+    }
     
     // initialize adjacency list with zeros
     int **adj_list = malloc(n * sizeof(int *));
@@ -25,7 +141,8 @@ int main() {
     }
     
     // print the result
-    printf("%d\n", acyclic(adj_list, n));
+    struct dfs_matrix M = {adj_list, n};
+    printf("%d\n", acyclic(&M, dfs_matrix_neighbor, n));
 
     // free the allocated memory
     for (int i = 0; i < n; i++) {
@@ -38,86 +155,248 @@ int main() {
 
 /**
  * acyclic() - Check whether the directed graph is acyclic.
- * @adj_list:  The adjacency list containing information about the edges
- *             and the direction of the edges. Each row and column index
- *             represent the vertices. If the the value is equal to 1, it
- *             means there is an directed edge. For example:
- *             adj_list[2][3] => (2) -> (3).
+ * @graph:     The graph, either the adjacency matrix in a struct dfs_matrix
+ *             or the CSR arrays in a struct dfs_csr. In the matrix each
+ *             row and column index represent the vertices. If the the
+ *             value is equal to 1, it means there is an directed edge. For
+ *             example: adj_list[2][3] => (2) -> (3).
+ * @neighbor:  The neighbour iterator of dfs.h for @graph
  * @n:         Number of vertices in the directed graph.
  *
- * The function checks if a directed graph has a cycle in it with the help
- * of @dfs() function. It iterates through the vertices to check if there
- * is a cycle or not. If so, it return true, it not it returns false.
+ * The function checks if a directed graph has a cycle in it with the
+ * iterative dfs of dfs.h. It iterates through the vertices and starts a
+ * search from every unvisited one. An edge to a vertex that is still on
+ * the dfs stack closes a cycle, which stops the search.
  *
- * Return: Return true if the directed graph acyclic i.e. DAG, otherwise
+ * Return: Return true if the directed graph has a cycle, otherwise
  *         it returns false
  */
 
-bool acyclic(int **adj_list, int n)
+bool acyclic(const void *graph, dfs_neighbor_fn neighbor, int n)
 {
-    int *visited = calloc(n, sizeof(int));
-    int *recursion_stack = calloc(n, sizeof(int));
+    struct dfs_visitor V = {NULL, NULL, found_cycle, NULL, NULL};
+    struct dfs *D = dfs_create(n, graph, neighbor);
 
     for (int i = 0; i < n; ++i) {
-        if (visited[i] == 0 && dfs(i, adj_list, visited, recursion_stack, n)) {
-            free(visited);
-            free(recursion_stack);
+        if (dfs_visit(D, i, &V)) {
+            dfs_free(D);
             return true;
         }
     }
 
-    free(visited);
-    free(recursion_stack);
+    dfs_free(D);
 
     return false;
 }
 
 /**
- * dfs() - Performs depth-first traverse to detect cycles in a directed graph.
- *
- * @v:         The current visited vertex
- * @visited:   Visited vertex array
- * @recursion_stack: Recursion stack array showing vertices in stack
- * @adj_list:  Adjacency list of the directed graph
- * @n:         The number of vertices
- *
- * This function recursively traverse the directed graph. The starting point of
- * traversal is the given vertex @v. It marks the vertex @v as visited and add
- * @v to the recursion stack. Then, with the help of the adjacency 2D array, the
- * edges between vertices detected. If the vertex is not visited, the vertices
- * recursively discovered.
- * Two returning condition appears:
- *     1-) if the vertex is not visited and there is a cycle return true.
- *     2-) if the vertex is in stack, return true.
- *
- * If there was not return in the for loop, meaning there is no cycle, then
- * remove the vertex @v from stack and return false.
- *
- * Return      Returns true if a cycle is detected, otherwise false
+ * found_cycle() - The back edge callback of the dfs.
+ *
+ * @u:   The vertex on top of the stack
+ * @v:   The vertex on the stack that @u points to
+ * @ctx: Unused
+ *
+ * Return      Returns true, any back edge closes a cycle
  */
 
-bool dfs(int v, int **adj_list, int *visited, int *recursion_stack,  int n)
+bool found_cycle(int u, int v, void *ctx)
 {
-    // mark the current vertex as visited
-    visited[v] = 1;
-    // add the current vertex to stack
-    recursion_stack[v] = 1;
+    (void)u;
+    (void)v;
+    (void)ctx;
+    return true;
+}
 
+/**
+ * create_order() - An empty graph with the order 0, 1, ..., n - 1.
+ *
+ * @n:         Number of vertices
+ *
+ * Return      The dynamic order
+ */
+
+struct dynamic_order *create_order(int n)
+{
+    struct dynamic_order *O = malloc(sizeof(struct dynamic_order));
+    O->n = n;
+    O->out = calloc(n > 0 ? n : 1, sizeof(struct bucket));
+    O->in = calloc(n > 0 ? n : 1, sizeof(struct bucket));
+    O->ord = malloc((n > 0 ? n : 1) * sizeof(int));
+    O->vertex = malloc((n > 0 ? n : 1) * sizeof(int));
+    O->mark = calloc(n > 0 ? n : 1, sizeof(bool));
+    O->forward = (struct bucket){0, 0, NULL};
+    O->backward = (struct bucket){0, 0, NULL};
+    O->stack = malloc((n > 0 ? n : 1) * sizeof(int));
+    O->pool = malloc((n > 0 ? n : 1) * sizeof(int));
     for (int i = 0; i < n; ++i) {
-        // if there is an edge between v and i, and i is not visited, then
-        // continue to traverse
-        if (adj_list[v][i] == 1) {
-            // if vertex is not visited and there is cyclye return true
-            if (visited[i] == 0 && dfs(i, adj_list, visited, recursion_stack, n))
-                return true;
-            // if vertex is aldready in stack, there is a cycle. return true
-            else if (recursion_stack[i] == 1)
-                return true;
+        O->ord[i] = i;
+        O->vertex[i] = i;
+    }
+    return O;
+}
+
+void free_order(struct dynamic_order *O)
+{
+    for (int i = 0; i < O->n; ++i) {
+        free(O->out[i].vertices);
+        free(O->in[i].vertices);
+    }
+    free(O->out);
+    free(O->in);
+    free(O->ord);
+    free(O->vertex);
+    free(O->mark);
+    free(O->forward.vertices);
+    free(O->backward.vertices);
+    free(O->stack);
+    free(O->pool);
+    free(O);
+}
+
+/**
+ * insert_edge() - Adds the edge x -> y unless it closes a cycle.
+ *
+ * @O:         The dynamic order
+ * @x:         The tail of the edge
+ * @y:         The head of the edge
+ *
+ * Pearce and Kelly, "A dynamic topological sort algorithm for directed
+ * acyclic graphs" (2006). Nothing changes if x is already before y.
+ * Otherwise only the vertices between y and x in the order can be
+ * affected: the ones y reaches and the ones reaching x. If y reaches x
+ * the edge closes a cycle. If not, the two sets swap places: the ones
+ * reaching x take the first of their joint positions, keeping their
+ * relative order, and the ones reached from y the rest. The work is
+ * bounded by the edges of the affected vertices, and the marks are
+ * cleared for those vertices only.
+ *
+ * Return      Returns true if the edge was added, false if it would
+ *             close a cycle
+ */
+
+bool insert_edge(struct dynamic_order *O, int x, int y)
+{
+    if (x == y)
+        return false;
+    int lb = O->ord[y], ub = O->ord[x];
+    if (lb < ub) {
+        O->forward.count = 0;
+        O->backward.count = 0;
+        bool added = search_forward(O, y, ub);
+        if (added) {
+            search_backward(O, x, lb);
+            reorder(O);
+        }
+        for (int i = 0; i < O->forward.count; ++i) {
+            O->mark[O->forward.vertices[i]] = false;
+        }
+        for (int i = 0; i < O->backward.count; ++i) {
+            O->mark[O->backward.vertices[i]] = false;
         }
+        if (!added)
+            return false;
     }
+    bucket_push(&O->out[x], y);
+    bucket_push(&O->in[y], x);
+    return true;
+}
 
-    // remove the current vertex from stack
-    recursion_stack[v] = 0;
-    return false;
+/**
+ * search_forward() - Finds the vertices y reaches before position ub.
+ *
+ * @O:         The dynamic order
+ * @y:         The head of the new edge
+ * @ub:        The position of the tail of the new edge
+ *
+ * Return      Returns false if the tail is reached, a cycle
+ */
+
+bool search_forward(struct dynamic_order *O, int y, int ub)
+{
+    int top = 0;
+    O->stack[0] = y;
+    O->mark[y] = true;
+    bucket_push(&O->forward, y);
+    while (top >= 0) {
+        int v = O->stack[top--];
+        for (int i = 0; i < O->out[v].count; ++i) {
+            int w = O->out[v].vertices[i];
+            if (O->ord[w] == ub)
+                return false;
+            if (!O->mark[w] && O->ord[w] < ub) {
+                O->mark[w] = true;
+                bucket_push(&O->forward, w);
+                O->stack[++top] = w;
+            }
+        }
+    }
+    return true;
+}
+
+/**
+ * search_backward() - Finds the vertices reaching x after position lb.
+ *
+ * @O:         The dynamic order
+ * @x:         The tail of the new edge
+ * @lb:        The position of the head of the new edge
+ *
+ * Return      None
+ */
+
+void search_backward(struct dynamic_order *O, int x, int lb)
+{
+    int top = 0;
+    O->stack[0] = x;
+    O->mark[x] = true;
+    bucket_push(&O->backward, x);
+    while (top >= 0) {
+        int v = O->stack[top--];
+        for (int i = 0; i < O->in[v].count; ++i) {
+            int w = O->in[v].vertices[i];
+            if (!O->mark[w] && O->ord[w] > lb) {
+                O->mark[w] = true;
+                bucket_push(&O->backward, w);
+                O->stack[++top] = w;
+            }
+        }
+    }
 }
 
+/**
+ * reorder() - Moves the vertices reaching x before the ones y reaches.
+ *
+ * @O:         The dynamic order, with the two searches done
+ *
+ * Both sets are sorted by position. Their positions, merged, are given
+ * to the backward set and then to the forward set.
+ *
+ * Return      None
+ */
+
+void reorder(struct dynamic_order *O)
+{
+    int b = O->backward.count, f = O->forward.count;
+    int *order = O->stack;
+    for (int i = 0; i < b; ++i) {
+        O->pool[i] = O->ord[O->backward.vertices[i]];
+    }
+    for (int i = 0; i < f; ++i) {
+        O->pool[b + i] = O->ord[O->forward.vertices[i]];
+    }
+    qsort(O->pool, b, sizeof(int), compare_ints);
+    qsort(O->pool + b, f, sizeof(int), compare_ints);
+    for (int i = 0; i < b + f; ++i) {
+        order[i] = O->vertex[O->pool[i]];
+    }
+    qsort(O->pool, b + f, sizeof(int), compare_ints);
+    for (int i = 0; i < b + f; ++i) {
+        O->ord[order[i]] = O->pool[i];
+        O->vertex[O->pool[i]] = order[i];
+    }
+}
+
+int compare_ints(const void *a, const void *b)
+{
+    int x = *(const int *)a, y = *(const int *)b;
+    return (x > y) - (x < y);
+}
@@ -0,0 +1,155 @@
+#ifndef DFS_H
+#define DFS_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+// state of a vertex during the search
+#define DFS_NEW  0  // not visited yet
+#define DFS_OPEN 1  // on the stack, its post-order call is pending
+#define DFS_DONE 2  // finished
+
+// neighbour iterator of a graph: returns the next neighbour of v at or
+// after position *next and moves *next past it, -1 when there is none
+typedef int (*dfs_neighbor_fn)(const void *graph, int v, int *next);
+
+// one call of the recursive version: the vertex and where its scan
+// of the neighbours stopped
+struct dfs_frame {
+    int v;
+    int next;
+};
+
+// iterative depth-first search over the vertices 0 .. n - 1, the
+// frames live on the heap so the depth is only limited by n. state[]
+// is kept between dfs_visit() calls, so a search over every vertex
+// calls it for each root that is still DFS_NEW
+struct dfs {
+    int n;
+    const void *graph;
+    dfs_neighbor_fn neighbor;
+    struct dfs_frame *stack;
+    unsigned char *state;
+};
+
+// the callbacks of a search, any of them may be NULL.
+// pre is called when v is entered and post when it is finished.
+// back_edge is called for an edge u -> v with v still on the stack,
+// returning true stops the search. after_edge is called for every
+// edge u -> v once v is no longer new, after the post call of v if the
+// edge entered it, like the code after the recursive call would be
+struct dfs_visitor {
+    void (*pre)(int v, void *ctx);
+    void (*post)(int v, void *ctx);
+    bool (*back_edge)(int u, int v, void *ctx);
+    void (*after_edge)(int u, int v, void *ctx);
+    void *ctx;
+};
+
+// adjacency lists, the neighbours of v are adj[v][0 .. count[v] - 1]
+struct dfs_lists {
+    int **adj;
+    int *count;
+};
+
+// CSR arrays, the neighbours of v are head[first[v] .. first[v + 1] - 1]
+struct dfs_csr {
+    const int *first;
+    const int *head;
+};
+
+// adjacency matrix, u -> v is an edge when adj[u][v] is nonzero
+struct dfs_matrix {
+    int **adj;
+    int n;
+};
+
+static inline int dfs_list_neighbor(const void *graph, int v, int *next) {
+    const struct dfs_lists *L = graph;
+    return *next < L->count[v] ? L->adj[v][(*next)++] : -1;
+}
+
+static inline int dfs_csr_neighbor(const void *graph, int v, int *next) {
+    const struct dfs_csr *C = graph;
+    int j = C->first[v] + *next;
+    if (j >= C->first[v + 1])
+        return -1;
+    (*next)++;
+    return C->head[j];
+}
+
+static inline int dfs_matrix_neighbor(const void *graph, int v, int *next) {
+    const struct dfs_matrix *M = graph;
+    const int *row = M->adj[v];
+    for (int i = *next; i < M->n; i++) {
+        if (row[i]) {
+            *next = i + 1;
+            return i;
+        }
+    }
+    *next = M->n;
+    return -1;
+}
+
+static inline struct dfs *dfs_create(int n, const void *graph, dfs_neighbor_fn neighbor) {
+    struct dfs *D = malloc(sizeof(struct dfs));
+    D->n = n;
+    D->graph = graph;
+    D->neighbor = neighbor;
+    D->stack = malloc((n > 0 ? n : 1) * sizeof(struct dfs_frame));
+    D->state = calloc(n > 0 ? n : 1, 1);
+    return D;
+}
+
+static inline void dfs_free(struct dfs *D) {
+    free(D->stack);
+    free(D->state);
+    free(D);
+}
+
+// marks every vertex DFS_NEW again
+static inline void dfs_reset(struct dfs *D) {
+    memset(D->state, DFS_NEW, D->n);
+}
+
+// searches from root if it is DFS_NEW, visiting the neighbours in the
+// order of the iterator just like the recursive version would. returns
+// true if a back_edge callback stopped the search, the vertices still
+// on the stack are then left DFS_OPEN
+static inline bool dfs_visit(struct dfs *D, int root, const struct dfs_visitor *V) {
+    if (D->state[root] != DFS_NEW)
+        return false;
+    int top = 0;
+    D->stack[0] = (struct dfs_frame){root, 0};
+    D->state[root] = DFS_OPEN;
+    if (V->pre)
+        V->pre(root, V->ctx);
+
+    while (top >= 0) {
+        struct dfs_frame *f = &D->stack[top];
+        int w = D->neighbor(D->graph, f->v, &f->next);
+        if (w < 0) {
+            int v = f->v;
+            D->state[v] = DFS_DONE;
+            if (V->post)
+                V->post(v, V->ctx);
+            top--;
+            if (top >= 0 && V->after_edge)
+                V->after_edge(D->stack[top].v, v, V->ctx);
+        } else if (D->state[w] == DFS_NEW) {
+            D->stack[++top] = (struct dfs_frame){w, 0};
+            D->state[w] = DFS_OPEN;
+            if (V->pre)
+                V->pre(w, V->ctx);
+        } else {
+            if (D->state[w] == DFS_OPEN && V->back_edge && V->back_edge(f->v, w, V->ctx))
+                return true;
+            if (V->after_edge)
+                V->after_edge(f->v, w, V->ctx);
+        }
+    }
+    return false;
+}
+
+#endif /* DFS_H */
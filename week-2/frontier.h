@@ -0,0 +1,124 @@
+#ifndef FRONTIER_H
+#define FRONTIER_H
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+
+// number of frontier vertices a thread takes at once
+#define CHUNK_SIZE 64
+
+// growable list of vertices, small at first as some programs keep one
+// per vertex
+struct bucket {
+    int count;
+    int capacity;
+    int *vertices;
+};
+
+static inline void bucket_push(struct bucket *b, int v) {
+    if (b->count == b->capacity) {
+        b->capacity = b->capacity ? 2 * b->capacity : 4;
+        b->vertices = realloc(b->vertices, b->capacity * sizeof(int));
+    }
+    b->vertices[b->count++] = v;
+}
+
+// number of edges of vertex u, used to give the threads equal work
+typedef long long int (*degree_fn)(const void *graph, int u);
+
+// thread t gets the vertices split[t] .. split[t + 1] - 1, starting at
+// the first vertex after about t / thread_count of the edges. a vertex
+// also counts as one edge, so vertices without edges are spread too
+static inline void split_by_edges(int *split, int thread_count, int n, long long int edges,
+                                  const void *graph, degree_fn degree) {
+    long long int seen = 0;
+    int u = 0;
+    split[0] = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        while (u < n && seen + degree(graph, u) + 1 <= (t + 1) * (edges + n) / thread_count) {
+            seen += degree(graph, u++) + 1;
+        }
+        split[t + 1] = t == thread_count - 1 ? n : u;
+    }
+}
+
+// the frontier of a level-synchronous search shared by thread_count
+// threads. thread t appends the vertices it finds for the next level to
+// local[t], then every thread calls frontier_exchange(), which joins the
+// buckets into vertices[0 .. total - 1]. total and offset are written by
+// thread 0 between two barriers and only read by the others, the threads
+// take chunks of vertices[] with frontier_claim()
+struct frontier {
+    int thread_count;
+    pthread_barrier_t *barrier;
+    struct bucket *local;
+    int *offset;
+    int *vertices;
+    int capacity;
+    int total;
+    atomic_int next;
+};
+
+// an empty frontier, barrier must be shared by exactly thread_count threads
+static inline void frontier_init(struct frontier *F, int thread_count,
+                                 pthread_barrier_t *barrier, int capacity) {
+    F->thread_count = thread_count;
+    F->barrier = barrier;
+    F->local = calloc(thread_count, sizeof(struct bucket));
+    F->offset = calloc(thread_count, sizeof(int));
+    F->capacity = capacity > 0 ? capacity : 1;
+    F->vertices = malloc(F->capacity * sizeof(int));
+    F->total = 0;
+    atomic_init(&F->next, 0);
+}
+
+static inline void frontier_free(struct frontier *F) {
+    for (int t = 0; t < F->thread_count; ++t) {
+        free(F->local[t].vertices);
+    }
+    free(F->local);
+    free(F->offset);
+    free(F->vertices);
+}
+
+// joins the local buckets into the next frontier and empties them, every
+// thread calls it with its index. the other threads wait at the last
+// barrier until every bucket is copied
+static inline void frontier_exchange(struct frontier *F, int id) {
+    pthread_barrier_wait(F->barrier);
+
+    if (id == 0) {
+        F->total = 0;
+        for (int t = 0; t < F->thread_count; ++t) {
+            F->offset[t] = F->total;
+            F->total += F->local[t].count;
+        }
+        if (F->total > F->capacity) {
+            F->capacity = F->total;
+            F->vertices = realloc(F->vertices, F->capacity * sizeof(int));
+        }
+        atomic_store(&F->next, 0);
+    }
+    pthread_barrier_wait(F->barrier);
+
+    struct bucket *local = &F->local[id];
+    if (local->count > 0)
+        memcpy(F->vertices + F->offset[id], local->vertices, local->count * sizeof(int));
+    local->count = 0;
+    pthread_barrier_wait(F->barrier);
+}
+
+// claims the next chunk vertices[*start .. *end - 1] of the frontier,
+// false once the whole frontier is taken
+static inline bool frontier_claim(struct frontier *F, int *start, int *end) {
+    *start = atomic_fetch_add(&F->next, CHUNK_SIZE);
+    if (*start >= F->total)
+        return false;
+    *end = *start + CHUNK_SIZE < F->total ? *start + CHUNK_SIZE : F->total;
+    return true;
+}
+
+#endif /* FRONTIER_H */
@@ -1,16 +1,301 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "dfs.h"
+#include "frontier.h"
+
+/* largest condensation indexed by its full transitive closure, count^2 bits */
+#define CLOSURE_LIMIT 16384
+
+/* interval labels per scc of the grail index */
+#define GRAIL_LABELS 3
+
+/* marks of the searches from the pivot */
+#define FORWARD  1
+#define BACKWARD 2
+
+/*
+ * order_stack - the stack filled with the vertices in post-order
+ * @rec_stack: stack array storing the finished vertices in order
+ * @top:       the top of @rec_stack
+ */
+struct order_stack {
+    int *rec_stack;
+    int top;
+};
+
+/*
+ * pearce - state of the one-pass scc search
+ * @rindex: while v is searched, the smallest dfs index v reaches in the
+ *          unfinished part of the graph; once the scc of v is found, the
+ *          id of the scc, counted down from n - 1
+ * @root:   whether rindex[v] is still the dfs index of v itself
+ * @stack:  the searched vertices whose scc is not found yet
+ * @top:    the top of @stack
+ * @index:  the next dfs index
+ * @c:      the next scc id
+ */
+struct pearce {
+    int *rindex;
+    bool *root;
+    int *stack;
+    int top;
+    int index;
+    int c;
+};
+
+/*
+ * digraph - directed graph in CSR form, with the reversed edges
+ * @n:         number of vertices
+ * @out_first: successors of v are out_head[out_first[v] .. out_first[v + 1] - 1]
+ * @out_head:  target of each edge
+ * @in_first:  predecessors of v are in_head[in_first[v] .. in_first[v + 1] - 1]
+ * @in_head:   source of each edge
+ */
+struct digraph {
+    int n;
+    int *out_first;
+    int *out_head;
+    int *in_first;
+    int *in_head;
+};
+
+/*
+ * scc_task - a set of vertices closed under sccs, searched by one thread
+ * @part:     id of the set, the value of part[] of its vertices
+ * @vertices: the vertices of the set
+ */
+struct scc_task {
+    int part;
+    struct bucket vertices;
+};
+
+/*
+ * task_stack - growable stack of tasks
+ */
+struct task_stack {
+    int count;
+    int capacity;
+    struct scc_task *tasks;
+};
+
+struct parallel_scc;
+
+/*
+ * scc_worker - the thread-local state of a parallel scc thread
+ * @id:     index of the thread
+ * @P:      the shared state
+ * @local:  the bucket of this thread in the frontier, the vertices it
+ *          found for the next level, also its trimming queue
+ * @split:  the vertices of this thread only reached forward, only
+ *          reached backward and not reached from the first pivot
+ * @best:   the best pivot candidate of the thread, -1 if none
+ * @score:  in-degree * out-degree of @best
+ */
+struct scc_worker {
+    int id;
+    struct parallel_scc *P;
+    struct bucket *local;
+    struct bucket split[3];
+    int best;
+    long long int score;
+};
+
+/*
+ * parallel_scc - state shared by the parallel scc threads
+ * @G:            the graph
+ * @thread_count: number of threads
+ * @split:        thread t scans the vertices split[t] .. split[t + 1] - 1
+ * @label:        the smallest vertex of the scc of each vertex, -1 while
+ *                its scc is not found
+ * @in_degree:    number of edges into each vertex from untrimmed vertices
+ * @out_degree:   number of edges from each vertex to untrimmed vertices
+ * @mark:         FORWARD and BACKWARD bits of the searches from a pivot
+ * @part:         the task each vertex without an scc belongs to
+ * @giant:        smallest vertex of the scc of the pivot
+ * @part_count:   number of task ids given out
+ * @workers:      the thread-local states
+ * @lock:         protects @tasks and @pending
+ * @task_added:   signaled when a task is pushed or the last one finished
+ * @tasks:        the tasks waiting for a thread
+ * @pending:      number of tasks waiting or running
+ * @barrier:      synchronizes the phases
+ * @pivot:        start of the forward and backward searches, -1 if every
+ *                vertex was trimmed, written by thread 0 between two
+ *                barriers and only read by the others
+ * @frontier:     the joint frontier of the current phase
+ */
+struct parallel_scc {
+    struct digraph *G;
+    int thread_count;
+    int *split;
+    _Atomic int *label;
+    _Atomic int *in_degree;
+    _Atomic int *out_degree;
+    _Atomic unsigned char *mark;
+    _Atomic int *part;
+    atomic_int giant;
+    atomic_int part_count;
+    struct scc_worker *workers;
+    pthread_mutex_t lock;
+    pthread_cond_t task_added;
+    struct task_stack tasks;
+    int pending;
+    pthread_barrier_t barrier;
+    int pivot;
+    struct frontier frontier;
+};
+
+/*
+ * condensation - the dag of the sccs, one vertex per scc
+ * @count: number of sccs, an edge c -> d always has d < c
+ * @first: successors of c are head[first[c] .. first[c + 1] - 1]
+ * @head:  target of each edge, without duplicates
+ */
+struct condensation {
+    int count;
+    int *first;
+    int *head;
+};
+
+/*
+ * reach_index - answers "can u reach v?" on the condensation
+ * @D:         the condensation
+ * @component: the scc of each vertex
+ * @words:     64-bit words per row of @closure
+ * @closure:   row c has the bits of the sccs c reaches, NULL if the
+ *             condensation is too large and grail labels are used
+ * @low:       grail interval starts, GRAIL_LABELS per scc
+ * @rank:      grail interval ends, the post-order rank of each traversal
+ * @stamp:     query number of the last search that visited each scc
+ * @query:     number of the current query
+ * @stack:     the search stack of a query
+ *
+ * Grail (Yildirim, Chaoji and Zaki, 2010): every traversal of the dag
+ * gives each scc the interval [low, rank] of the post-order ranks below
+ * it, and the interval of a reachable scc is always inside it. A query
+ * is rejected when any interval is not contained, and otherwise decided
+ * by a search that skips every scc whose intervals cannot contain v's.
+ */
+struct reach_index {
+    struct condensation *D;
+    int *component;
+    int words;
+    uint64_t *closure;
+    int *low;
+    int *rank;
+    int *stamp;
+    int query;
+    int *stack;
+};
+
+/*
+ * grail_traversal - the state of one labelling traversal of the dag
+ * @I:        the index being labelled
+ * @label:    which of the GRAIL_LABELS traversals
+ * @reversed: visit the successors from the last one
+ * @next:     the next post-order rank
+ */
+struct grail_traversal {
+    struct reach_index *I;
+    int label;
+    bool reversed;
+    int next;
+};
 
 // function prototypes
+void answer_queries(int **adj_list, int *out_going_edge_count, int n, bool grail, bool print_time);
+struct condensation *build_condensation(int **adj_list, int *out_going_edge_count, int n,
+                                        const int *component, int count);
+struct reach_index *build_reach_index(struct condensation *D, int *component, bool grail);
+void free_reach_index(struct reach_index *I);
+bool reaches(struct reach_index *I, int u, int v);
+bool grail_contains(const struct reach_index *I, int c, int d);
+int grail_neighbor(const void *graph, int v, int *next);
+void grail_enter(int c, void *ctx);
+void grail_edge(int c, int d, void *ctx);
+void grail_finish(int c, void *ctx);
+struct digraph *build_digraph(int **adj_list, int *out_going_edge_count, int n);
+void free_digraph(struct digraph *G);
+int find_sccs_parallel(struct digraph *G, int thread_count, int *component);
+void *scc_worker(void *arg);
+void trim_vertex(struct scc_worker *W, int v);
+void pivot_search(struct scc_worker *W, const int *first, const int *head, unsigned char bit);
+void run_tasks(struct scc_worker *W);
+void split_task(struct scc_worker *W, struct scc_task *T);
+void push_task(struct parallel_scc *P, int part, struct bucket *vertices);
+bool atomic_min(_Atomic int *target, int value);
+long long int digraph_degree(const void *graph, int v);
+void record_vertex(int v, void *ctx);
+int find_sccs_pearce(int **adj_list, int *out_going_edge_count, int n, int *component);
+void pearce_enter(int v, void *ctx);
+void pearce_edge(int u, int v, void *ctx);
+void pearce_finish(int v, void *ctx);
 int pop(int *rec_stack, int *top);
 void push(int *rec_stack, int *top, int v);
 int find_sccs(int **adj_list, int *out_going_edge_count, int n);
 int **reverse_adj_list(int **adj_list, int *out_going_edge_count, int *incoming_edge_count, int n);
 
-int main(void)
+/*
+ * usage: ./a.out [--kosaraju | --threads=<t>] [--labels] [--time] < graph
+ *        ./a.out --queries [--grail] [--time] < graph
+ *     --kosaraju     two dfs passes over G^R and G instead of the one-pass search
+ *     --threads=<t>  trimming and forward-backward searches on t threads
+ *     --labels       also print the label of every vertex, the smallest
+ *                    vertex of its scc
+ *     --queries      read "u v" queries until the end of the input and
+ *                    print 1 if u reaches v, 0 if not, one per line
+ *     --grail        index the queries with interval labels even when the
+ *                    transitive closure would fit
+ *     --time         print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
 {
+    bool kosaraju = false;
+    bool labels = false;
+    bool queries = false;
+    bool grail = false;
+    bool print_time = false;
+    int thread_count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--kosaraju") == 0) {
+            kosaraju = true;
+        } else if (strcmp(argv[i], "--labels") == 0) {
+            labels = true;
+        } else if (strcmp(argv[i], "--queries") == 0) {
+            queries = true;
+        } else if (strcmp(argv[i], "--grail") == 0) {
+            grail = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (kosaraju && (labels || thread_count)) {
+        fprintf(stderr, "--kosaraju only counts the sccs on one thread\n");
+        return 1;
+    }
+    if (queries ? kosaraju || labels || thread_count : grail) {
+        fprintf(stderr, "--queries only goes with --grail and --time\n");
+        return 1;
+    }
+
     // get # of vertices and # of edges
     int n, m;
     scanf("%d %d", &n, &m);
@@ -29,11 +314,58 @@ int main(void)
         adj_list[a][out_going_edge_count[a]++] = b;
     }
 
+    if (queries) {
+        answer_queries(adj_list, out_going_edge_count, n, grail, print_time);
+        for (int i = 0; i < n; ++i) {
+            free(adj_list[i]);
+        }
+        free(adj_list);
+        free(out_going_edge_count);
+        return 0;
+    }
+
     // strongly CC
-    int scc_number = find_sccs(adj_list, out_going_edge_count, n);
+    struct timespec start, end;
+    int *component = calloc(n > 0 ? n : 1, sizeof(int));
+    int scc_number;
+    if (thread_count) {
+        // the parallel search labels the sccs by their smallest vertex
+        struct digraph *G = build_digraph(adj_list, out_going_edge_count, n);
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        scc_number = find_sccs_parallel(G, thread_count, component);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free_digraph(G);
+    } else {
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        scc_number = kosaraju ? find_sccs(adj_list, out_going_edge_count, n)
+                              : find_sccs_pearce(adj_list, out_going_edge_count, n, component);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+
+        // the first vertex met of every scc is its smallest one
+        int *smallest = malloc((scc_number > 0 ? scc_number : 1) * sizeof(int));
+        for (int i = 0; i < scc_number; ++i) {
+            smallest[i] = -1;
+        }
+        for (int i = 0; i < n && !kosaraju; ++i) {
+            if (smallest[component[i]] == -1)
+                smallest[component[i]] = i;
+            component[i] = smallest[component[i]];
+        }
+        free(smallest);
+    }
 
     // print the result
     printf("%d\n", scc_number);
+    if (labels) {
+        for (int i = 0; i < n; ++i) {
+            printf(i + 1 < n ? "%d " : "%d\n", component[i] + 1);
+        }
+    }
+    if (print_time) {
+        fprintf(stderr, "%d threads: %.3f ms\n", thread_count ? thread_count : 1,
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
+    free(component);
     
     // free the allocated memory
     for (int i = 0; i < n; ++i) {
@@ -46,26 +378,16 @@ int main(void)
 }
 
 /**
- * dfs - depth-first search function
- * @v:                    current vertex
- * @adj_list:             adjacency list representing directed graph
- * @out_going_edge_count: array storing the outgoing edge number per vertex
- * @visited:              array storing the visited vertices
- * @rec_stack:            stack array storing the recursively called vertices in order
- * @top:                  pointer indicating the top location of @rec_stack
+ * record_vertex - post-order callback of the dfs, pushes the finished vertex
+ * @v:   the finished vertex
+ * @ctx: the struct order_stack
  *
  * Return:                None
  */
-void dfs(int v, int **adj_list, int *out_going_edge_count, int *visited, int *rec_stack, int *top)
+void record_vertex(int v, void *ctx)
 {
-    visited[v] = 1;
-    for (int i = 0; i < out_going_edge_count[v]; ++i) {
-        int destination_vertex_idx = adj_list[v][i];
-        if (visited[destination_vertex_idx] == 0) {
-            dfs(destination_vertex_idx, adj_list, out_going_edge_count, visited, rec_stack, top);
-        }
-    }
-    push(rec_stack, top, v);
+    struct order_stack *S = ctx;
+    push(S->rec_stack, &S->top, v);
 }
 
 /**
@@ -102,36 +424,39 @@ int **reverse_adj_list(int **adj_list, int *out_going_edge_count, int *incoming_
  *
  * The function performs DFS first on G^R and then fill the the @rec_stack
  * in the order of visit. Then, again, perfoms DFS on G to count the number
- * of SCCs. Every performed DFS for a particular vertex means one SCC.
+ * of SCCs. Every performed DFS for a particular vertex means one SCC. Both
+ * searches use the iterative dfs of dfs.h.
  *
  * Return:                the number of SCCs
  */
 int find_sccs(int **adj_list, int *out_going_edge_count, int n)
 {
-    int top = -1;
-    int *visited = calloc(n, sizeof(int));
-    int *rec_stack = calloc(2 * n, sizeof(int));
+    struct order_stack S = {calloc(n, sizeof(int)), -1};
     int *incoming_edge_count = calloc(n, sizeof(int));
 
     // create the reversed adj_list (graph)
     int **reversed_adj_list = reverse_adj_list(adj_list, out_going_edge_count, incoming_edge_count, n);
 
     // dfs on G^R
+    struct dfs_lists reversed = {reversed_adj_list, incoming_edge_count};
+    struct dfs_visitor record = {NULL, record_vertex, NULL, NULL, &S};
+    struct dfs *D = dfs_create(n, &reversed, dfs_list_neighbor);
     for (int i = 0; i < n; ++i) {
-        if (visited[i] == 0) {
-            dfs(i, reversed_adj_list, incoming_edge_count, visited, rec_stack, &top);
-        }
+        dfs_visit(D, i, &record);
     }
 
-    // reset visited array to zeros
-    memset(visited, 0, n * sizeof(int));
+    // mark every vertex unvisited again and search G
+    struct dfs_lists forward = {adj_list, out_going_edge_count};
+    struct dfs_visitor none = {NULL, NULL, NULL, NULL, NULL};
+    dfs_reset(D);
+    D->graph = &forward;
 
     // find the number of strongly connected components (SCCs)
     int scc_count = 0;
-    while (top != -1) {
-        int v = pop(rec_stack, &top);
-        if (visited[v] == 0) {
-            dfs(v, adj_list, out_going_edge_count, visited, rec_stack, &top);
+    while (S.top != -1) {
+        int v = pop(S.rec_stack, &S.top);
+        if (D->state[v] == DFS_NEW) {
+            dfs_visit(D, v, &none);
             scc_count++;
         }
     }
@@ -141,13 +466,870 @@ int find_sccs(int **adj_list, int *out_going_edge_count, int n)
         free(reversed_adj_list[i]);
     }
     free(reversed_adj_list);
-    free(visited);
-    free(rec_stack);
+    dfs_free(D);
+    free(S.rec_stack);
     free(incoming_edge_count);
 
     return scc_count;
 }
 
+/**
+ * find_sccs_pearce - finds strongly connected components in one dfs pass
+ * @adj_list:             adjacency list representing directed graph
+ * @out_going_edge_count: array storing the outgoing edge number per vertex
+ * @n:                    number of vertices
+ * @component:            filled with the scc id of every vertex
+ *
+ * Pearce's space-efficient variant of Tarjan's algorithm ("A space-efficient
+ * algorithm for finding strongly connected components", 2016). A single
+ * dfs on G gives every vertex an index, and after each edge u -> v the
+ * rindex of u is lowered to the rindex of v. A vertex whose rindex was
+ * never lowered is the root of an scc, which is made of it and the
+ * vertices above it on the stack. Found sccs get ids counted down from
+ * n - 1 and the index is given back, so finished vertices can never
+ * lower the rindex of a searched one. @component doubles as the rindex
+ * array and no reversed graph is built.
+ *
+ * Return:                the number of SCCs, the ids are 0 .. count - 1
+ *                        in the order the sccs were finished, which is a
+ *                        reverse topological order of the condensation
+ */
+int find_sccs_pearce(int **adj_list, int *out_going_edge_count, int n, int *component)
+{
+    struct pearce P;
+    P.rindex = component;
+    P.root = malloc((n > 0 ? n : 1) * sizeof(bool));
+    P.stack = malloc((n > 0 ? n : 1) * sizeof(int));
+    P.top = -1;
+    P.index = 0;
+    P.c = n - 1;
+
+    struct dfs_lists L = {adj_list, out_going_edge_count};
+    struct dfs_visitor V = {pearce_enter, pearce_finish, NULL, pearce_edge, &P};
+    struct dfs *D = dfs_create(n, &L, dfs_list_neighbor);
+    for (int i = 0; i < n; ++i) {
+        dfs_visit(D, i, &V);
+    }
+
+    for (int i = 0; i < n; ++i) {
+        component[i] = n - 1 - component[i];
+    }
+
+    dfs_free(D);
+    free(P.root);
+    free(P.stack);
+
+    return n - 1 - P.c;
+}
+
+/**
+ * pearce_enter - pre-order callback, gives @v the next dfs index
+ * @v:   the entered vertex
+ * @ctx: the struct pearce
+ *
+ * Return:                None
+ */
+void pearce_enter(int v, void *ctx)
+{
+    struct pearce *P = ctx;
+    P->rindex[v] = P->index++;
+    P->root[v] = true;
+}
+
+/**
+ * pearce_edge - lowers the rindex of @u to the rindex of @v
+ * @u:   the searched vertex
+ * @v:   the vertex @u points to, searched or finished
+ * @ctx: the struct pearce
+ *
+ * Return:                None
+ */
+void pearce_edge(int u, int v, void *ctx)
+{
+    struct pearce *P = ctx;
+    if (P->rindex[v] < P->rindex[u]) {
+        P->rindex[u] = P->rindex[v];
+        P->root[u] = false;
+    }
+}
+
+/**
+ * pearce_finish - post-order callback, pops the scc of @v if it is a root
+ * @v:   the finished vertex
+ * @ctx: the struct pearce
+ *
+ * Return:                None
+ */
+void pearce_finish(int v, void *ctx)
+{
+    struct pearce *P = ctx;
+    if (!P->root[v]) {
+        push(P->stack, &P->top, v);
+        return;
+    }
+    P->index--;
+    while (P->top != -1 && P->rindex[v] <= P->rindex[P->stack[P->top]]) {
+        int w = pop(P->stack, &P->top);
+        P->rindex[w] = P->c;
+        P->index--;
+    }
+    P->rindex[v] = P->c--;
+}
+
+/**
+ * answer_queries - answers the "u v" queries left in the input
+ * @adj_list:             adjacency list representing directed graph
+ * @out_going_edge_count: array storing the outgoing edge number per vertex
+ * @n:                    number of vertices
+ * @grail:                use grail labels even for a small condensation
+ * @print_time:           print the time of the index and the queries
+ *
+ * Return:                None
+ */
+void answer_queries(int **adj_list, int *out_going_edge_count, int n, bool grail, bool print_time)
+{
+    struct timespec start, built, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    int *component = calloc(n > 0 ? n : 1, sizeof(int));
+    int count = find_sccs_pearce(adj_list, out_going_edge_count, n, component);
+    struct condensation *D = build_condensation(adj_list, out_going_edge_count, n, component, count);
+    struct reach_index *I = build_reach_index(D, component, grail);
+    clock_gettime(CLOCK_MONOTONIC, &built);
+
+    int u, v, query_count = 0;
+    while (scanf("%d %d", &u, &v) == 2) {
+        printf("%d\n", reaches(I, u - 1, v - 1));
+        query_count++;
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    if (print_time) {
+        fprintf(stderr, "%d sccs, %s index: %.3f ms, %d queries: %.3f ms\n", count,
+                I->closure ? "closure" : "grail",
+                (built.tv_sec - start.tv_sec) * 1e3 + (built.tv_nsec - start.tv_nsec) / 1e6,
+                query_count,
+                (end.tv_sec - built.tv_sec) * 1e3 + (end.tv_nsec - built.tv_nsec) / 1e6);
+    }
+
+    free_reach_index(I);
+    free(D->first);
+    free(D->head);
+    free(D);
+    free(component);
+}
+
+/**
+ * build_condensation - contracts every scc to one vertex
+ * @adj_list:             adjacency list representing directed graph
+ * @out_going_edge_count: array storing the outgoing edge number per vertex
+ * @n:                    number of vertices
+ * @component:            the scc ids of find_sccs_pearce()
+ * @count:                number of sccs
+ *
+ * the vertices are grouped by scc with a counting sort, then the edges
+ * of each group are collected, skipping the ones inside the scc and the
+ * ones to an scc already seen from it.
+ *
+ * Return:                the condensation
+ */
+struct condensation *build_condensation(int **adj_list, int *out_going_edge_count, int n,
+                                        const int *component, int count)
+{
+    int *start = calloc(count + 1, sizeof(int));
+    int *order = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int i = 0; i < n; ++i) {
+        start[component[i] + 1]++;
+    }
+    for (int c = 0; c < count; ++c) {
+        start[c + 1] += start[c];
+    }
+    for (int i = 0; i < n; ++i) {
+        order[start[component[i]]++] = i;
+    }
+    for (int c = count; c > 0; --c) {
+        start[c] = start[c - 1];
+    }
+    start[0] = 0;
+
+    struct condensation *D = malloc(sizeof(struct condensation));
+    D->count = count;
+    D->first = malloc((count + 1) * sizeof(int));
+    struct bucket edges = {0, 0, NULL};
+    int *seen = malloc((count > 0 ? count : 1) * sizeof(int));
+    for (int c = 0; c < count; ++c) {
+        seen[c] = -1;
+    }
+    for (int c = 0; c < count; ++c) {
+        D->first[c] = edges.count;
+        seen[c] = c;
+        for (int k = start[c]; k < start[c + 1]; ++k) {
+            int v = order[k];
+            for (int j = 0; j < out_going_edge_count[v]; ++j) {
+                int d = component[adj_list[v][j]];
+                if (seen[d] != c) {
+                    seen[d] = c;
+                    bucket_push(&edges, d);
+                }
+            }
+        }
+    }
+    D->first[count] = edges.count;
+    D->head = edges.vertices;
+
+    free(seen);
+    free(start);
+    free(order);
+    return D;
+}
+
+/**
+ * build_reach_index - indexes the condensation for reachability queries
+ * @D:         the condensation
+ * @component: the scc of each vertex, kept by the index
+ * @grail:     use grail labels even if the closure would fit
+ *
+ * up to CLOSURE_LIMIT sccs the whole transitive closure is kept as a
+ * bit matrix. The sccs are numbered in reverse topological order, so
+ * the row of every successor is complete when it is or-ed into its
+ * predecessor's row, one 64-bit word at a time. Larger condensations
+ * get GRAIL_LABELS grail intervals per scc, from traversals that differ
+ * in the order of the roots and of the successors.
+ *
+ * Return:     the index
+ */
+struct reach_index *build_reach_index(struct condensation *D, int *component, bool grail)
+{
+    struct reach_index *I = calloc(1, sizeof(struct reach_index));
+    int count = D->count;
+    I->D = D;
+    I->component = component;
+
+    if (!grail && count <= CLOSURE_LIMIT) {
+        I->words = (count + 63) / 64;
+        I->closure = calloc((size_t)count * I->words + 1, sizeof(uint64_t));
+        for (int c = 0; c < count; ++c) {
+            uint64_t *row = I->closure + (size_t)c * I->words;
+            row[c / 64] |= 1ULL << (c % 64);
+            for (int j = D->first[c]; j < D->first[c + 1]; ++j) {
+                const uint64_t *succ = I->closure + (size_t)D->head[j] * I->words;
+                for (int w = 0; w <= D->head[j] / 64; ++w) {
+                    row[w] |= succ[w];
+                }
+            }
+        }
+        return I;
+    }
+
+    I->low = malloc(((size_t)count * GRAIL_LABELS + 1) * sizeof(int));
+    I->rank = malloc(((size_t)count * GRAIL_LABELS + 1) * sizeof(int));
+    I->stamp = calloc(count > 0 ? count : 1, sizeof(int));
+    I->stack = malloc((count > 0 ? count : 1) * sizeof(int));
+
+    struct dfs *S = dfs_create(count, NULL, grail_neighbor);
+    for (int k = 0; k < GRAIL_LABELS; ++k) {
+        struct grail_traversal T = {I, k, k & 1, 0};
+        struct dfs_visitor V = {grail_enter, grail_finish, NULL, grail_edge, &T};
+        S->graph = &T;
+        dfs_reset(S);
+        for (int i = 0; i < count; ++i) {
+            dfs_visit(S, k & 2 ? i : count - 1 - i, &V);
+        }
+    }
+    dfs_free(S);
+    return I;
+}
+
+void free_reach_index(struct reach_index *I)
+{
+    free(I->closure);
+    free(I->low);
+    free(I->rank);
+    free(I->stamp);
+    free(I->stack);
+    free(I);
+}
+
+/**
+ * reaches - whether vertex @u reaches vertex @v
+ * @I: the index
+ * @u: a vertex
+ * @v: a vertex
+ *
+ * Return:     true if there is a path from @u to @v
+ */
+bool reaches(struct reach_index *I, int u, int v)
+{
+    int c = I->component[u], d = I->component[v];
+    if (c == d)
+        return true;
+
+    // an edge always goes to a smaller scc id
+    if (d > c)
+        return false;
+    if (I->closure)
+        return I->closure[(size_t)c * I->words + d / 64] >> (d % 64) & 1;
+    if (!grail_contains(I, c, d))
+        return false;
+
+    // search the sccs whose intervals contain the ones of d
+    struct condensation *D = I->D;
+    int top = 0;
+    I->query++;
+    I->stack[0] = c;
+    I->stamp[c] = I->query;
+    while (top >= 0) {
+        int x = I->stack[top--];
+        for (int j = D->first[x]; j < D->first[x + 1]; ++j) {
+            int y = D->head[j];
+            if (y == d)
+                return true;
+            if (I->stamp[y] != I->query && y > d && grail_contains(I, y, d)) {
+                I->stamp[y] = I->query;
+                I->stack[++top] = y;
+            }
+        }
+    }
+    return false;
+}
+
+/**
+ * grail_contains - whether every interval of @c contains the one of @d
+ * @I: the index
+ * @c: an scc
+ * @d: an scc
+ *
+ * Return:     false if @c cannot reach @d
+ */
+bool grail_contains(const struct reach_index *I, int c, int d)
+{
+    const int *low_c = I->low + (size_t)c * GRAIL_LABELS, *low_d = I->low + (size_t)d * GRAIL_LABELS;
+    const int *rank_c = I->rank + (size_t)c * GRAIL_LABELS, *rank_d = I->rank + (size_t)d * GRAIL_LABELS;
+    for (int k = 0; k < GRAIL_LABELS; ++k) {
+        if (low_d[k] < low_c[k] || rank_d[k] > rank_c[k])
+            return false;
+    }
+    return true;
+}
+
+/**
+ * grail_neighbor - successor iterator of the condensation for dfs.h
+ * @graph: the struct grail_traversal
+ * @v:     an scc
+ * @next:  position in the successors of @v
+ *
+ * Return:     the next successor, -1 if none is left
+ */
+int grail_neighbor(const void *graph, int v, int *next)
+{
+    const struct grail_traversal *T = graph;
+    const struct condensation *D = T->I->D;
+    int degree = D->first[v + 1] - D->first[v];
+    if (*next >= degree)
+        return -1;
+    int j = T->reversed ? D->first[v + 1] - 1 - *next : D->first[v] + *next;
+    (*next)++;
+    return D->head[j];
+}
+
+void grail_enter(int c, void *ctx)
+{
+    struct grail_traversal *T = ctx;
+    T->I->low[(size_t)c * GRAIL_LABELS + T->label] = INT32_MAX;
+}
+
+// low of c is the smallest rank below it, its successors are finished
+void grail_edge(int c, int d, void *ctx)
+{
+    struct grail_traversal *T = ctx;
+    int *low = T->I->low;
+    if (low[(size_t)d * GRAIL_LABELS + T->label] < low[(size_t)c * GRAIL_LABELS + T->label])
+        low[(size_t)c * GRAIL_LABELS + T->label] = low[(size_t)d * GRAIL_LABELS + T->label];
+}
+
+void grail_finish(int c, void *ctx)
+{
+    struct grail_traversal *T = ctx;
+    size_t i = (size_t)c * GRAIL_LABELS + T->label;
+    T->I->rank[i] = T->next++;
+    if (T->I->rank[i] < T->I->low[i])
+        T->I->low[i] = T->I->rank[i];
+}
+
+/**
+ * build_digraph - copies the adjacency list into CSR arrays, both ways
+ * @adj_list:             adjacency list representing directed graph
+ * @out_going_edge_count: array storing the outgoing edge number per vertex
+ * @n:                    number of vertices
+ *
+ * Return:                the graph
+ */
+struct digraph *build_digraph(int **adj_list, int *out_going_edge_count, int n)
+{
+    struct digraph *G = malloc(sizeof(struct digraph));
+    G->n = n;
+    G->out_first = calloc(n + 1, sizeof(int));
+    G->in_first = calloc(n + 2, sizeof(int));
+    for (int i = 0; i < n; ++i) {
+        G->out_first[i + 1] = G->out_first[i] + out_going_edge_count[i];
+        for (int j = 0; j < out_going_edge_count[i]; ++j) {
+            G->in_first[adj_list[i][j] + 2]++;
+        }
+    }
+    int m = G->out_first[n];
+    G->out_head = malloc((m > 0 ? m : 1) * sizeof(int));
+    G->in_head = malloc((m > 0 ? m : 1) * sizeof(int));
+
+    // in_first[v + 1] is the next free position of v while filling
+    for (int i = 0; i < n; ++i) {
+        G->in_first[i + 2] += G->in_first[i + 1];
+    }
+    for (int i = 0; i < n; ++i) {
+        for (int j = 0; j < out_going_edge_count[i]; ++j) {
+            G->out_head[G->out_first[i] + j] = adj_list[i][j];
+        }
+        for (int j = 0; j < out_going_edge_count[i]; ++j) {
+            G->in_head[G->in_first[adj_list[i][j] + 1]++] = i;
+        }
+    }
+    return G;
+}
+
+void free_digraph(struct digraph *G)
+{
+    free(G->out_first);
+    free(G->out_head);
+    free(G->in_first);
+    free(G->in_head);
+    free(G);
+}
+
+/**
+ * find_sccs_parallel - finds strongly connected components on threads
+ * @G:            the graph
+ * @thread_count: number of threads
+ * @component:    filled with the smallest vertex of the scc of every vertex
+ *
+ * The forward-backward method (Fleischer, Hendrickson and Pinar, 2000)
+ * with the improvements of Hong, Rodia and Olukotun (2013):
+ *   1) trimming: a vertex without edges from or to the rest of the graph
+ *      is an scc by itself. The degrees are counted down atomically, so
+ *      removing a vertex can trim its neighbours right away.
+ *   2) the scc of the pivot, the vertex with the largest in-degree *
+ *      out-degree, is the intersection of the parallel breadth-first
+ *      searches from it over G and G^R. It is usually the giant scc.
+ *   3) the rest splits into the vertices only reached forward, only
+ *      reached backward and not reached. No scc crosses these sets, so
+ *      each one is a task for the same search from a pivot of its own,
+ *      which splits it again. The tasks are taken from a shared stack
+ *      by whichever thread is free.
+ *
+ * Return:        the number of SCCs
+ */
+int find_sccs_parallel(struct digraph *G, int thread_count, int *component)
+{
+    int n = G->n;
+    struct parallel_scc P;
+    P.G = G;
+    P.thread_count = thread_count;
+    P.split = malloc((thread_count + 1) * sizeof(int));
+    P.label = malloc((n > 0 ? n : 1) * sizeof(_Atomic int));
+    P.in_degree = malloc((n > 0 ? n : 1) * sizeof(_Atomic int));
+    P.out_degree = malloc((n > 0 ? n : 1) * sizeof(_Atomic int));
+    P.mark = malloc((n > 0 ? n : 1) * sizeof(_Atomic unsigned char));
+    P.part = malloc((n > 0 ? n : 1) * sizeof(_Atomic int));
+    atomic_init(&P.giant, n);
+    atomic_init(&P.part_count, 3);
+    pthread_mutex_init(&P.lock, NULL);
+    pthread_cond_init(&P.task_added, NULL);
+    P.tasks = (struct task_stack){0, 0, NULL};
+    P.pending = 0;
+    pthread_barrier_init(&P.barrier, NULL, thread_count);
+    frontier_init(&P.frontier, thread_count, &P.barrier, n);
+    for (int v = 0; v < n; ++v) {
+        atomic_init(&P.label[v], -1);
+        atomic_init(&P.in_degree[v], G->in_first[v + 1] - G->in_first[v]);
+        atomic_init(&P.out_degree[v], G->out_first[v + 1] - G->out_first[v]);
+        atomic_init(&P.mark[v], 0);
+        atomic_init(&P.part[v], -1);
+    }
+
+    // the edges are counted both ways
+    split_by_edges(P.split, thread_count, n, 2LL * G->out_first[n], G, digraph_degree);
+
+    P.workers = calloc(thread_count, sizeof(struct scc_worker));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 0; t < thread_count; ++t) {
+        P.workers[t].id = t;
+        P.workers[t].P = &P;
+        P.workers[t].local = &P.frontier.local[t];
+    }
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, scc_worker, &P.workers[t]);
+    }
+    scc_worker(&P.workers[0]);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    int scc_count = 0;
+    for (int v = 0; v < n; ++v) {
+        component[v] = atomic_load(&P.label[v]);
+        if (component[v] == v)
+            scc_count++;
+    }
+
+    pthread_barrier_destroy(&P.barrier);
+    pthread_mutex_destroy(&P.lock);
+    pthread_cond_destroy(&P.task_added);
+    frontier_free(&P.frontier);
+    for (int t = 0; t < thread_count; ++t) {
+        for (int k = 0; k < 3; ++k) {
+            free(P.workers[t].split[k].vertices);
+        }
+    }
+    free(P.tasks.tasks);
+    free(threads);
+    free(P.workers);
+    free(P.split);
+    free(P.label);
+    free(P.in_degree);
+    free(P.out_degree);
+    free(P.mark);
+    free(P.part);
+
+    return scc_count;
+}
+
+/**
+ * scc_worker - the phases run by every parallel scc thread
+ * @arg: the worker
+ *
+ * All threads go through the same sequence of barriers. Thread 0 makes
+ * the decisions (pivot, frontier offsets) between two barriers, the
+ * other threads read them after the second one.
+ *
+ * Return:       NULL
+ */
+void *scc_worker(void *arg)
+{
+    struct scc_worker *W = arg;
+    struct parallel_scc *P = W->P;
+    struct digraph *G = P->G;
+    int lo = P->split[W->id], hi = P->split[W->id + 1];
+
+    // trimming, the local bucket is the queue of vertices to trim
+    for (int v = lo; v < hi; ++v) {
+        if (atomic_load_explicit(&P->in_degree[v], memory_order_relaxed) == 0 ||
+            atomic_load_explicit(&P->out_degree[v], memory_order_relaxed) == 0)
+            trim_vertex(W, v);
+        while (W->local->count > 0) {
+            trim_vertex(W, W->local->vertices[--W->local->count]);
+        }
+    }
+
+    // the pivot candidate of every thread
+    W->best = -1;
+    W->score = -1;
+    for (int v = lo; v < hi; ++v) {
+        if (atomic_load_explicit(&P->label[v], memory_order_relaxed) != -1)
+            continue;
+        long long int score = (long long int)atomic_load_explicit(&P->in_degree[v], memory_order_relaxed) *
+                              atomic_load_explicit(&P->out_degree[v], memory_order_relaxed);
+        if (score > W->score) {
+            W->best = v;
+            W->score = score;
+        }
+    }
+    pthread_barrier_wait(&P->barrier);
+
+    if (W->id == 0) {
+        P->pivot = -1;
+        long long int score = -1;
+        for (int t = 0; t < P->thread_count; ++t) {
+            if (P->workers[t].score > score) {
+                P->pivot = P->workers[t].best;
+                score = P->workers[t].score;
+            }
+        }
+    }
+    pthread_barrier_wait(&P->barrier);
+
+    if (P->pivot != -1) {
+        pivot_search(W, G->out_first, G->out_head, FORWARD);
+        pivot_search(W, G->in_first, G->in_head, BACKWARD);
+
+        // the scc of the pivot is the intersection of the two searches
+        for (int v = lo; v < hi; ++v) {
+            if (atomic_load_explicit(&P->mark[v], memory_order_relaxed) == (FORWARD | BACKWARD)) {
+                atomic_min(&P->giant, v);
+                break;
+            }
+        }
+        pthread_barrier_wait(&P->barrier);
+
+        // the rest is split by the marks into the first three tasks
+        int giant = atomic_load_explicit(&P->giant, memory_order_relaxed);
+        for (int v = lo; v < hi; ++v) {
+            unsigned char mark = atomic_load_explicit(&P->mark[v], memory_order_relaxed);
+            atomic_store_explicit(&P->mark[v], 0, memory_order_relaxed);
+            if (mark == (FORWARD | BACKWARD)) {
+                atomic_store_explicit(&P->label[v], giant, memory_order_relaxed);
+            } else if (atomic_load_explicit(&P->label[v], memory_order_relaxed) == -1) {
+                int k = mark == FORWARD ? 0 : mark == BACKWARD ? 1 : 2;
+                atomic_store_explicit(&P->part[v], k, memory_order_relaxed);
+                bucket_push(&W->split[k], v);
+            }
+        }
+        pthread_barrier_wait(&P->barrier);
+
+        if (W->id == 0) {
+            // the others wait at the barrier, so the lock is free, but
+            // push_task() expects it to be held
+            pthread_mutex_lock(&P->lock);
+            for (int k = 0; k < 3; ++k) {
+                struct bucket vertices = {0, 0, NULL};
+                for (int t = 0; t < P->thread_count; ++t) {
+                    struct bucket *b = &P->workers[t].split[k];
+                    for (int i = 0; i < b->count; ++i) {
+                        bucket_push(&vertices, b->vertices[i]);
+                    }
+                }
+                push_task(P, k, &vertices);
+            }
+            pthread_mutex_unlock(&P->lock);
+        }
+        pthread_barrier_wait(&P->barrier);
+        run_tasks(W);
+    }
+    return NULL;
+}
+
+/**
+ * trim_vertex - makes @v an scc by itself if no other thread did
+ * @W: the worker
+ * @v: a vertex without edges from or without edges to untrimmed vertices
+ *
+ * the neighbours of @v that lose their last edge from or to untrimmed
+ * vertices are queued in the local bucket.
+ *
+ * Return:    None
+ */
+void trim_vertex(struct scc_worker *W, int v)
+{
+    struct parallel_scc *P = W->P;
+    struct digraph *G = P->G;
+    int expected = -1;
+    if (!atomic_compare_exchange_strong_explicit(&P->label[v], &expected, v,
+                                                 memory_order_relaxed, memory_order_relaxed))
+        return;
+    for (int j = G->out_first[v]; j < G->out_first[v + 1]; ++j) {
+        int w = G->out_head[j];
+        if (atomic_fetch_sub_explicit(&P->in_degree[w], 1, memory_order_relaxed) == 1)
+            bucket_push(W->local, w);
+    }
+    for (int j = G->in_first[v]; j < G->in_first[v + 1]; ++j) {
+        int w = G->in_head[j];
+        if (atomic_fetch_sub_explicit(&P->out_degree[w], 1, memory_order_relaxed) == 1)
+            bucket_push(W->local, w);
+    }
+}
+
+/**
+ * pivot_search - parallel breadth-first search from the pivot
+ * @W:     the worker
+ * @first: CSR offsets of the direction to search
+ * @head:  CSR edges of the direction to search
+ * @bit:   FORWARD or BACKWARD, set on every vertex reached
+ *
+ * only the vertices still without an scc are searched. The frontier
+ * of each level is claimed in chunks, the vertices are claimed with
+ * an atomic or on their mark.
+ *
+ * Return:    None
+ */
+void pivot_search(struct scc_worker *W, const int *first, const int *head, unsigned char bit)
+{
+    struct parallel_scc *P = W->P;
+    struct frontier *F = &P->frontier;
+    if (W->id == 0) {
+        atomic_fetch_or_explicit(&P->mark[P->pivot], bit, memory_order_relaxed);
+        bucket_push(W->local, P->pivot);
+    }
+    frontier_exchange(F, W->id);
+
+    while (F->total > 0) {
+        int start, end;
+        while (frontier_claim(F, &start, &end)) {
+            for (int i = start; i < end; ++i) {
+                int v = F->vertices[i];
+                for (int j = first[v]; j < first[v + 1]; ++j) {
+                    int w = head[j];
+                    if (atomic_load_explicit(&P->label[w], memory_order_relaxed) == -1 &&
+                        !(atomic_fetch_or_explicit(&P->mark[w], bit, memory_order_relaxed) & bit))
+                        bucket_push(W->local, w);
+                }
+            }
+        }
+        frontier_exchange(F, W->id);
+    }
+}
+
+/**
+ * run_tasks - searches tasks until none is waiting or running
+ * @W: the worker
+ *
+ * Return:    None
+ */
+void run_tasks(struct scc_worker *W)
+{
+    struct parallel_scc *P = W->P;
+    pthread_mutex_lock(&P->lock);
+    while (true) {
+        while (P->tasks.count == 0 && P->pending > 0) {
+            pthread_cond_wait(&P->task_added, &P->lock);
+        }
+        if (P->tasks.count == 0)
+            break;
+        struct scc_task T = P->tasks.tasks[--P->tasks.count];
+        pthread_mutex_unlock(&P->lock);
+
+        split_task(W, &T);
+        free(T.vertices.vertices);
+
+        pthread_mutex_lock(&P->lock);
+        if (--P->pending == 0)
+            pthread_cond_broadcast(&P->task_added);
+    }
+    pthread_mutex_unlock(&P->lock);
+}
+
+/**
+ * split_task - finds the scc of a pivot of the task and splits the rest
+ * @W: the worker
+ * @T: the task
+ *
+ * the vertices of the task reached both from and to the middle vertex
+ * of the list are its scc, the ones reached one way or not at all are
+ * pushed as three new tasks. only the vertices of the task are
+ * searched, so the marks need no atomic claims.
+ *
+ * Return:    None
+ */
+void split_task(struct scc_worker *W, struct scc_task *T)
+{
+    struct parallel_scc *P = W->P;
+    struct digraph *G = P->G;
+    int count = T->vertices.count;
+    int *vertices = T->vertices.vertices;
+    if (count == 1) {
+        atomic_store_explicit(&P->label[vertices[0]], vertices[0], memory_order_relaxed);
+        return;
+    }
+
+    int pivot = vertices[count / 2];
+    for (int k = 0; k < 2; ++k) {
+        const int *first = k == 0 ? G->out_first : G->in_first;
+        const int *head = k == 0 ? G->out_head : G->in_head;
+        unsigned char bit = k == 0 ? FORWARD : BACKWARD;
+        atomic_fetch_or_explicit(&P->mark[pivot], bit, memory_order_relaxed);
+        bucket_push(W->local, pivot);
+        while (W->local->count > 0) {
+            int v = W->local->vertices[--W->local->count];
+            for (int j = first[v]; j < first[v + 1]; ++j) {
+                int w = head[j];
+                if (atomic_load_explicit(&P->part[w], memory_order_relaxed) == T->part &&
+                    !(atomic_load_explicit(&P->mark[w], memory_order_relaxed) & bit)) {
+                    atomic_fetch_or_explicit(&P->mark[w], bit, memory_order_relaxed);
+                    bucket_push(W->local, w);
+                }
+            }
+        }
+    }
+
+    // the smallest vertex of the scc labels it
+    int smallest = G->n;
+    for (int i = 0; i < count; ++i) {
+        int v = vertices[i];
+        if (atomic_load_explicit(&P->mark[v], memory_order_relaxed) == (FORWARD | BACKWARD) && v < smallest)
+            smallest = v;
+    }
+
+    int part = atomic_fetch_add(&P->part_count, 3);
+    struct bucket split[3] = {{0, 0, NULL}, {0, 0, NULL}, {0, 0, NULL}};
+    for (int i = 0; i < count; ++i) {
+        int v = vertices[i];
+        unsigned char mark = atomic_load_explicit(&P->mark[v], memory_order_relaxed);
+        atomic_store_explicit(&P->mark[v], 0, memory_order_relaxed);
+        if (mark == (FORWARD | BACKWARD)) {
+            atomic_store_explicit(&P->label[v], smallest, memory_order_relaxed);
+            atomic_store_explicit(&P->part[v], -1, memory_order_relaxed);
+        } else {
+            int k = mark == FORWARD ? 0 : mark == BACKWARD ? 1 : 2;
+            atomic_store_explicit(&P->part[v], part + k, memory_order_relaxed);
+            bucket_push(&split[k], v);
+        }
+    }
+
+    pthread_mutex_lock(&P->lock);
+    for (int k = 0; k < 3; ++k) {
+        push_task(P, part + k, &split[k]);
+    }
+    pthread_mutex_unlock(&P->lock);
+}
+
+/**
+ * push_task - pushes the vertices as a task, the caller holds the lock
+ * @P:        the shared state
+ * @part:     id of the task
+ * @vertices: the vertices, owned by the task from now on
+ *
+ * Return:    None
+ */
+void push_task(struct parallel_scc *P, int part, struct bucket *vertices)
+{
+    if (vertices->count == 0) {
+        free(vertices->vertices);
+        return;
+    }
+    if (P->tasks.count == P->tasks.capacity) {
+        P->tasks.capacity = P->tasks.capacity ? 2 * P->tasks.capacity : 16;
+        P->tasks.tasks = realloc(P->tasks.tasks, P->tasks.capacity * sizeof(struct scc_task));
+    }
+    P->tasks.tasks[P->tasks.count++] = (struct scc_task){part, *vertices};
+    P->pending++;
+    pthread_cond_signal(&P->task_added);
+}
+
+/**
+ * digraph_degree - the number of edges of a vertex both ways
+ * @graph: the digraph
+ * @v:     the vertex
+ *
+ * Return:    the degree, for split_by_edges()
+ */
+long long int digraph_degree(const void *graph, int v)
+{
+    const struct digraph *G = graph;
+    return (G->out_first[v + 1] - G->out_first[v]) + (G->in_first[v + 1] - G->in_first[v]);
+}
+
+/**
+ * atomic_min - lowers @target to @value if @value is smaller
+ * @target: the atomic value
+ * @value:  the new value
+ *
+ * Return:      true if @target was lowered
+ */
+bool atomic_min(_Atomic int *target, int value)
+{
+    int old = atomic_load_explicit(target, memory_order_relaxed);
+    while (value < old) {
+        if (atomic_compare_exchange_weak_explicit(target, &old, value, memory_order_relaxed, memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
 /**
  * push - pushes the vertext @v to the @rec_stack
  * @rec_stack: the stack used for recording topological ordering of vertices
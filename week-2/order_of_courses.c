@@ -1,13 +1,113 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+#include "dfs.h"
+#include "frontier.h"
+
+/*
+ * order_stack - the stack filled with the vertices in post-order
+ * @rec_stack: the stack used for recording topological ordering of vertices
+ * @top:       the top of @rec_stack
+ */
+struct order_stack {
+    int *rec_stack;
+    int top;
+};
+
+struct parallel_kahn;
+
+/*
+ * kahn_worker - the thread-local state of a kahn thread
+ * @id:     index of the thread, its bucket in the frontier
+ * @P:      the shared state
+ */
+struct kahn_worker {
+    int id;
+    struct parallel_kahn *P;
+};
+
+/*
+ * parallel_kahn - state shared by the kahn threads
+ * @adj_list:             the adjacency list of the graph
+ * @out_going_edge_count: the array that counts the number of outgoing edges
+ * @n:                    the number of vertices
+ * @thread_count:         number of threads
+ * @split:                thread t counts the edges of split[t] .. split[t + 1] - 1
+ * @in_degree:            number of edges into each vertex from unleveled vertices
+ * @level:                the level of each vertex, -1 until it has one
+ * @workers:              the thread-local states
+ * @barrier:              synchronizes the phases
+ * @frontier:             the vertices of the current level
+ * @depth:                the number of levels, written by thread 0 at the end
+ */
+struct parallel_kahn {
+    int **adj_list;
+    int *out_going_edge_count;
+    int n;
+    int thread_count;
+    int *split;
+    atomic_int *in_degree;
+    int *level;
+    struct kahn_worker *workers;
+    pthread_barrier_t barrier;
+    struct frontier frontier;
+    int depth;
+};
 
 // function prototypes
 void topological_sort(int **adj_list, int *out_going_edge_count, int n);
-void dfs(int v, int **adj_list, int *out_going_edge_count, int *visited, int *rec_stack, int *top);
+int topological_levels(int **adj_list, int *out_going_edge_count, int n, int thread_count, int *level);
+void *kahn_thread(void *arg);
+long long int list_degree(const void *graph, int v);
+void print_levels(const int *level, int n, int depth, bool by_level);
+void record_vertex(int v, void *ctx);
 void push(int *rec_stack, int *top, int v);
 int pop(int *rec_stack, int *top);
 
-int main() {
+/*
+ * usage: ./a.out [--kahn | --levels] [--threads=<t>] [--time] < graph
+ *     --kahn         level-synchronous kahn's algorithm on threads, prints
+ *                    the levels one after the other, each by vertex number
+ *     --levels       like --kahn, one line per level
+ *     --threads=<t>  threads for --kahn and --levels (default: number of
+ *                    online cpus)
+ *     --time         print the time of the sort to stderr
+ *
+ * with --kahn or --levels, the vertices left because of a cycle are
+ * printed on a last line starting with "cycle:".
+ */
+int main(int argc, char *argv[]) {
+    bool kahn = false;
+    bool by_level = false;
+    bool print_time = false;
+    int thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--kahn") == 0) {
+            kahn = true;
+        } else if (strcmp(argv[i], "--levels") == 0) {
+            kahn = true;
+            by_level = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     // get #vertices and #edges
     int n, m;
     scanf("%d%d", &n, &m);
@@ -47,7 +147,22 @@ int main() {
         out_going_edge_count[a]++;
     }
 
-    topological_sort(adj_list, out_going_edge_count, n);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (kahn) {
+        int *level = malloc((n > 0 ? n : 1) * sizeof(int));
+        int depth = topological_levels(adj_list, out_going_edge_count, n, thread_count, level);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        print_levels(level, n, depth, by_level);
+        free(level);
+    } else {
+        topological_sort(adj_list, out_going_edge_count, n);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+    }
+    if (print_time) {
+        fprintf(stderr, "%d threads: %.3f ms\n", kahn ? thread_count : 1,
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
     
     // free the allocated memory
     for (int i = 0; i < n; i++) {
@@ -60,28 +175,17 @@ int main() {
 }
 
 /**
- * dfs - performs depth-first search from a given vertex @v
- * @v:                    the starting vertex of dfs
- * @adj_list:             the adjacency list of the DAG
- * @out_going_edge_count: the array that counts the number of outgoing edges
- * @visited:              the array keeping track of visited vertices
- * @rec_stack:            the stack used for recording topological ordering of vertices
- * @top:                  the integer pointer pointing the top of the @rec_stack
- *
- * The function performs a depth-search traversal starting from @v and recursively traverse
- * all the vertices and fills the @rec_stack array with the vertices by topological order
+ * record_vertex - the post-order callback of the dfs, pushes @v once
+ *                 all the vertices reachable from it are on the stack
+ * @v:   the finished vertex
+ * @ctx: the struct order_stack
  *
  * Return: None
  */
-void dfs(int v, int **adj_list, int *out_going_edge_count, int *visited, int *rec_stack, int *top)
+void record_vertex(int v, void *ctx)
 {
-    visited[v] = 1;
-    for (int i = 0; i < out_going_edge_count[v]; ++i) {
-        if (visited[adj_list[v][i]] == 0) {
-            dfs(adj_list[v][i], adj_list, out_going_edge_count, visited, rec_stack, top);
-        }
-    }
-    push(rec_stack, top, v);
+    struct order_stack *S = ctx;
+    push(S->rec_stack, &S->top, v);
 }
 
 /**
@@ -90,33 +194,207 @@ void dfs(int v, int **adj_list, int *out_going_edge_count, int *visited, int *re
  * @out_going_edge_count: the array that counts the number of outgoing edges
  * @n:                    the number of vertices of DAG
  *
- * It performs topological sort to the DAG with the help of dfs() function
- * and print out the result by poping out of the rec_stack
+ * It performs topological sort to the DAG with the iterative dfs of dfs.h,
+ * which pushes every vertex to the rec_stack once it is finished, and
+ * prints out the result by poping out of the rec_stack
  *
  * Returns: None
  */
 void topological_sort(int **adj_list, int *out_going_edge_count, int n)
 {
-    int top = -1;
-    int *visited = calloc(n, sizeof(int));
-    int *rec_stack = calloc(n, sizeof(int));
+    struct order_stack S = {calloc(n, sizeof(int)), -1};
+    struct dfs_lists L = {adj_list, out_going_edge_count};
+    struct dfs_visitor V = {NULL, record_vertex, NULL, NULL, &S};
+    struct dfs *D = dfs_create(n, &L, dfs_list_neighbor);
 
     for (int i = 0; i < n; ++i) {
-        if (visited[i] == 0) {
-            dfs(i, adj_list, out_going_edge_count, visited, rec_stack, &top);
-        }
+        dfs_visit(D, i, &V);
     }
     
     // print the result
-    while(top >= 1) {
+    while(S.top >= 1) {
         // adjust for 1-based index
-        printf("%d ", pop(rec_stack, &top) + 1);
+        printf("%d ", pop(S.rec_stack, &S.top) + 1);
     }
-    printf("%d", pop(rec_stack, &top) + 1);
+    printf("%d", pop(S.rec_stack, &S.top) + 1);
 
     // free memory
-    free(visited);
-    free(rec_stack);
+    dfs_free(D);
+    free(S.rec_stack);
+}
+
+/**
+ * topological_levels - kahn's algorithm, one frontier level at a time
+ * @adj_list:             the adjacency list of the graph
+ * @out_going_edge_count: the array that counts the number of outgoing edges
+ * @n:                    the number of vertices
+ * @thread_count:         number of threads
+ * @level:                filled with the level of every vertex
+ *
+ * The in-degrees are counted by all threads with atomic increments. The
+ * vertices without incoming edges are level 0, and a vertex is in level
+ * k + 1 when its last incoming edge from level k is removed. The threads
+ * take the frontier in chunks and remove the edges with atomic
+ * decrements, so each vertex is found by exactly one of them. The
+ * vertices of one level never depend on each other.
+ *
+ * Returns: the number of levels, the vertices on or after a cycle are
+ *          left at level -1
+ */
+int topological_levels(int **adj_list, int *out_going_edge_count, int n, int thread_count, int *level)
+{
+    struct parallel_kahn P;
+    P.adj_list = adj_list;
+    P.out_going_edge_count = out_going_edge_count;
+    P.n = n;
+    P.thread_count = thread_count;
+    P.split = malloc((thread_count + 1) * sizeof(int));
+    P.in_degree = malloc((n > 0 ? n : 1) * sizeof(atomic_int));
+    P.level = level;
+    P.depth = 0;
+    pthread_barrier_init(&P.barrier, NULL, thread_count);
+    frontier_init(&P.frontier, thread_count, &P.barrier, n);
+
+    long long int m = 0;
+    for (int v = 0; v < n; ++v) {
+        atomic_init(&P.in_degree[v], 0);
+        level[v] = -1;
+        m += out_going_edge_count[v];
+    }
+
+    split_by_edges(P.split, thread_count, n, m, out_going_edge_count, list_degree);
+
+    P.workers = malloc(thread_count * sizeof(struct kahn_worker));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 0; t < thread_count; ++t) {
+        P.workers[t] = (struct kahn_worker){t, &P};
+    }
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, kahn_thread, &P.workers[t]);
+    }
+    kahn_thread(&P.workers[0]);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_barrier_destroy(&P.barrier);
+    frontier_free(&P.frontier);
+    free(threads);
+    free(P.workers);
+    free(P.split);
+    free(P.in_degree);
+
+    return P.depth;
+}
+
+/**
+ * kahn_thread - the phases run by every kahn thread
+ * @arg: the worker
+ *
+ * All threads go through the same sequence of barriers, so they all
+ * count the same levels. Thread 0 computes the frontier offsets between
+ * two barriers, the other threads read them after the second one.
+ *
+ * Returns: NULL
+ */
+void *kahn_thread(void *arg)
+{
+    struct kahn_worker *W = arg;
+    struct parallel_kahn *P = W->P;
+    struct frontier *F = &P->frontier;
+    struct bucket *local = &F->local[W->id];
+    int lo = P->split[W->id], hi = P->split[W->id + 1];
+
+    for (int v = lo; v < hi; ++v) {
+        for (int i = 0; i < P->out_going_edge_count[v]; ++i) {
+            atomic_fetch_add_explicit(&P->in_degree[P->adj_list[v][i]], 1, memory_order_relaxed);
+        }
+    }
+    pthread_barrier_wait(&P->barrier);
+
+    for (int v = lo; v < hi; ++v) {
+        if (atomic_load_explicit(&P->in_degree[v], memory_order_relaxed) == 0)
+            bucket_push(local, v);
+    }
+    frontier_exchange(F, W->id);
+
+    int depth = 0;
+    while (F->total > 0) {
+        int start, end;
+        while (frontier_claim(F, &start, &end)) {
+            for (int j = start; j < end; ++j) {
+                int v = F->vertices[j];
+                P->level[v] = depth;
+                for (int i = 0; i < P->out_going_edge_count[v]; ++i) {
+                    int w = P->adj_list[v][i];
+                    if (atomic_fetch_sub_explicit(&P->in_degree[w], 1, memory_order_relaxed) == 1)
+                        bucket_push(local, w);
+                }
+            }
+        }
+        frontier_exchange(F, W->id);
+        depth++;
+    }
+    if (W->id == 0)
+        P->depth = depth;
+    return NULL;
+}
+
+/**
+ * list_degree - the number of outgoing edges of a vertex
+ * @graph: the out_going_edge_count array
+ * @v:     the vertex
+ *
+ * Returns: the degree, for split_by_edges()
+ */
+long long int list_degree(const void *graph, int v)
+{
+    return ((const int *)graph)[v];
+}
+
+/**
+ * print_levels - prints the vertices level by level
+ * @level:    the level of every vertex, -1 for the ones left by a cycle
+ * @n:        the number of vertices
+ * @depth:    the number of levels
+ * @by_level: one line per level instead of one line for all of them
+ *
+ * a counting sort by level keeps the vertices of a level in increasing
+ * order, whichever thread found them.
+ *
+ * Returns: None
+ */
+void print_levels(const int *level, int n, int depth, bool by_level)
+{
+    int *start = calloc(depth + 2, sizeof(int));
+    int *order = malloc((n > 0 ? n : 1) * sizeof(int));
+    for (int v = 0; v < n; ++v) {
+        start[level[v] + 1]++;
+    }
+    for (int k = 0; k <= depth; ++k) {
+        start[k + 1] += start[k];
+    }
+    // the cycle is bucket 0, the levels are buckets 1 .. depth
+    for (int v = 0; v < n; ++v) {
+        order[--start[level[v] + 1]] = v;
+    }
+
+    for (int k = 1; k <= depth; ++k) {
+        for (int i = start[k + 1] - 1; i >= start[k]; --i) {
+            bool last = i == start[k] && (by_level || k == depth);
+            printf(last ? "%d\n" : "%d ", order[i] + 1);
+        }
+    }
+    if (start[1] > 0) {
+        printf("cycle:");
+        for (int i = start[1] - 1; i >= 0; --i) {
+            printf(" %d", order[i] + 1);
+        }
+        printf("\n");
+    }
+
+    free(start);
+    free(order);
 }
 
 /**
@@ -0,0 +1,37 @@
+#!/bin/bash
+
+# usage: ./bench_order_of_courses.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 -pthread ../../../week-2/order_of_courses.c -Wall -lm -o bench.out &&
+
+# n vertices, m random edges from smaller to larger vertices
+generate_dag() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            u = int(n * rand()) + 1
+            v = int(n * rand()) + 1
+            if (u == v)
+                v = u % n + 1
+            if (u > v)
+                print v, u
+            else
+                print u, v
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_dag 1000000 5000000 1 > "$tmp_dir/dag"
+
+echo "$(head -n 1 "$tmp_dir/dag") dag"
+echo "    dfs: $(./bench.out --time < "$tmp_dir/dag" 2>&1 >/dev/null)"
+for (( t = 1; t <= max_threads; ++t ))
+do
+    echo "    --kahn $(./bench.out --kahn --threads=$t --time < "$tmp_dir/dag" 2>&1 >/dev/null)"
+done
+
+rm -rf "$tmp_dir" bench.out
@@ -1,7 +1,7 @@
 #!/bin/bash
 
 # compile the C code with debugging symbols
-gcc -g -pipe -O0 -std=c11 ../../../week-2/order_of_courses.c -lm -o a.out &&
+gcc -g -pipe -O0 -std=c11 -pthread ../../../week-2/order_of_courses.c -lm -o a.out &&
 
 # define an array of test case numbers
 test_cases=("01" "02" "03" "04")
@@ -0,0 +1,64 @@
+#!/bin/bash
+
+# usage: ./bench_intersection_reachability.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 -pthread ../../../week-2/intersection_reachability.c -Wall -lm -o bench.out &&
+
+# n vertices, m random edges, mostly one giant scc
+generate_random() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            print int(n * rand()) + 1, int(n * rand()) + 1
+        }
+    }'
+}
+
+# cycles of 20 vertices and m edges to later vertices, a deep dag of sccs
+generate_cycles() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, n + m
+        for (v = 1; v <= n; ++v) {
+            print v, (v % 20 == 0 || v == n) ? v - (v - 1) % 20 : v + 1
+        }
+        for (i = 0; i < m; ++i) {
+            u = int(n * rand()) + 1
+            v = u + 1 + int(n / 10 * rand())
+            print u, (v > n ? n : v)
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_random 1000000 5000000 1 > "$tmp_dir/random"
+generate_cycles 1000000 2000000 2 > "$tmp_dir/cycles"
+
+# the time in ms from a "<t> threads: <ms> ms" line
+milliseconds() {
+    awk '{ print $3 }'
+}
+
+for graph in random cycles
+do
+    echo "$graph: $(head -n 1 "$tmp_dir/$graph") graph"
+    pearce=$(./bench.out --time < "$tmp_dir/$graph" 2>&1 >/dev/null)
+    pearce_ms=$(echo "$pearce" | milliseconds)
+    echo "    pearce: $pearce"
+    for (( t = 1; t <= max_threads; ++t ))
+    do
+        line=$(./bench.out --threads=$t --time < "$tmp_dir/$graph" 2>&1 >/dev/null)
+        ms=$(echo "$line" | milliseconds)
+        if (( t == 1 )); then
+            one_ms=$ms
+        fi
+        # speedup over one thread of the same algorithm and over pearce
+        echo "    --threads $line, speedup $(awk -v a="$one_ms" -v b="$ms" -v p="$pearce_ms" \
+            'BEGIN { printf "%.2fx, %.2fx over pearce", a / b, p / b }')"
+    done
+done
+
+rm -rf "$tmp_dir" bench.out
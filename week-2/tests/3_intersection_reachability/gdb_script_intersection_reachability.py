@@ -16,7 +16,7 @@ def print_adj_list(adj_list):
 
 gdb.execute("break main")
 gdb.execute("break find_sccs")
-gdb.execute("break dfs")
+gdb.execute("break dfs_visit")
 gdb.execute("break reverse_adj_list")
-gdb.execute("run < cases/03")
+gdb.execute("run --kosaraju < cases/03")
 
@@ -0,0 +1,74 @@
+#!/bin/bash
+
+# compile the C code with debugging symbols
+gcc -g -pipe -O0 -std=c11 -pthread ../../../week-2/order_of_courses.c -lm -o a.out &&
+
+# define an array of test case numbers
+test_cases=("01" "02" "03" "04" "05")
+
+# program options, the levels of kahn's algorithm one after the other
+modes=("--kahn --threads=1" "--kahn --threads=3")
+
+# colors
+RED='\033[0;31m'
+RED_BOLD='\033[1;31m'
+GREEN_BOLD='\033[1;32m'
+NC='\033[0m'    # No Color
+
+# iterate over the program options and the test case files
+for mode in "${modes[@]}"
+do
+    for i in "${test_cases[@]}"
+    do
+        # case 04 is the 100000-vertex chain of 2_order_of_courses, read from there
+        input="cases/$i"
+        if [ "$i" == "04" ]; then
+            input="../2_order_of_courses/cases/04"
+        fi
+
+        # execute the program using Valgrind and capture the output
+        valgrind_output=$(valgrind --leak-check=full ./a.out $mode < "$input" 2>&1)
+
+        # check if valgrind reported any memory leaks
+        if [[ "$valgrind_output" =~ "All heap blocks were freed -- no leaks are possible" ]]; then
+            memory_leak_info="${GREEN_BOLD}without memory leak${NC}"
+        else
+            memory_leak_info="${RED_BOLD}with memory leak${NC}"
+        fi
+
+        # check if valgrind reported any conditional jump based on uninitialised value(s)
+        if ! [[ "$valgrind_output" =~ "Conditional jump or move depends on uninitialised value(s)" ]]; then
+            conditional_jump=""
+        else
+            conditional_jump=" - ${RED_BOLD}with conditional jump based on uninitialised value${NC}"
+        fi
+
+        # execute the program again and capture the program's output
+        result=$(./a.out $mode < "$input")
+
+        # read the expected output from the file
+        expected=$(cat "$input.a")
+
+        # compare the result and the expected output
+        # if there is a trailing space, it will appear as a red block character.
+        if [ "$result" != "$expected" ]; then
+            echo -e "Test case $i ${mode} failed ${memory_leak_info}${conditional_jump}"
+            echo "Input:"
+            cat "$input"
+            echo -e "\nYour result:"
+            echo -e "$result" | sed -E "s/[[:space:]]+$/$(printf "${RED}█${NC}")/"
+            echo -e "\nExpected result:"
+            echo -e "$expected" | sed -E "s/[[:space:]]+$/$(printf "${RED}█${NC}")/"
+            echo
+            exit 1
+        else
+            echo -e "Test case $i ${mode} passed ${memory_leak_info}${conditional_jump}"
+        fi
+    done
+
+
+done
+
+echo "All tests passed."
+
+
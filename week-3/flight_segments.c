@@ -1,9 +1,22 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdint.h>
 #include <stdbool.h>
+#include <string.h>
+#include <time.h>
 
 #define QUEUE_CAPACITY 1000000
 
+/* switch to bottom-up once the frontier has more than 1 / ALPHA of the
+ * edges of the unvisited vertices */
+#define ALPHA 14
+
+/* switch back to top-down once a shrinking frontier has fewer than
+ * 1 / BETA of the vertices */
+#define BETA 24
+
 struct queue {
     int *nodes;
     int front;
@@ -16,9 +29,39 @@ void enqueue(struct queue *q, int node);
 bool is_empty(struct queue *q);
 int bfs(int u, int v, int **adj_list, int n, int *edge_count);
 struct queue *initialize_queue();
+int bfs_hybrid(int source, int target, int **adj_list, int n, int *edge_count, int *dist);
+int top_down_step(int **adj_list, int *edge_count, int *dist, uint64_t *visited,
+                  const int *frontier, int count, int *next, int level, long long int *next_edges);
+int bottom_up_step(int **adj_list, int *edge_count, int n, int *dist, uint64_t *visited,
+                   const uint64_t *frontier, uint64_t *next, int level, long long int *next_edges);
 
-int main(void)
+/*
+ * usage: ./a.out [--hybrid | --distances] [--time] < graph
+ *     --hybrid     direction-optimizing search, which scans the edges of
+ *                  the unvisited vertices instead of the frontier when the
+ *                  frontier is large
+ *     --distances  also print the distance of every vertex from u, -1 if
+ *                  it is unreachable, found with the --hybrid search
+ *     --time       print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
 {
+    bool hybrid = false;
+    bool distances = false;
+    bool print_time = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--hybrid") == 0) {
+            hybrid = true;
+        } else if (strcmp(argv[i], "--distances") == 0) {
+            distances = true;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     // get # of vertices and # of edges
     int n, m;
     scanf("%d %d", &n, &m);
@@ -44,8 +87,32 @@ int main(void)
     scanf("%d %d", &u, &v);
 
     // print the result
-    int min_number_of_flight_segment = bfs(u - 1, v - 1, adj_list, n, edge_count);
+    struct timespec start, end;
+    int min_number_of_flight_segment;
+    int *dist = NULL;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (distances) {
+        // the search does not stop at v, every distance is needed
+        dist = malloc(n * sizeof(int));
+        bfs_hybrid(u - 1, -1, adj_list, n, edge_count, dist);
+        min_number_of_flight_segment = dist[v - 1];
+    } else if (hybrid) {
+        dist = malloc(n * sizeof(int));
+        min_number_of_flight_segment = bfs_hybrid(u - 1, v - 1, adj_list, n, edge_count, dist);
+    } else {
+        min_number_of_flight_segment = bfs(u - 1, v - 1, adj_list, n, edge_count);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
     printf("%d\n", min_number_of_flight_segment);
+    if (distances) {
+        for (int i = 0; i < n; ++i) {
+            printf(i + 1 < n ? "%d " : "%d\n", dist[i]);
+        }
+    }
+    if (print_time) {
+        fprintf(stderr, "%.3f ms\n",
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
 
     // free allocated memory
     for (int i = 0; i < n; ++i) {
@@ -53,6 +120,7 @@ int main(void)
     }
     free(adj_list);
     free(edge_count);
+    free(dist);
     return 0;
 }
 
@@ -111,6 +179,191 @@ int bfs(int source, int target, int **adj_list, int n, int *edge_count)
     return source_target_min_distance;
 }
 
+/**
+ * bfs_hybrid - direction-optimizing breadth first search
+ * @source:     source vertex index
+ * @target:     target vertex index, -1 to visit every reachable vertex
+ * @adj_list:   adjacency list representing undirected graph
+ * @n:          number of vertices
+ * @edge_count: array keeping track of number of edges for a specific edge
+ * @dist:       filled with the distance of every vertex from @source, -1
+ *              for the vertices that were not reached
+ *
+ * Each level is expanded in one of two directions:
+ *     - top-down: every vertex of the frontier, kept in an array, scans
+ *         its edges for unvisited vertices, like bfs().
+ *     - bottom-up: every unvisited vertex scans its edges for a vertex of
+ *         the frontier, kept in a bitmap, and stops at the first one.
+ * On low-diameter graphs the middle levels hold most of the vertices, and
+ * top-down then looks at nearly every edge while most of the vertices it
+ * finds are already visited. Bottom-up is used while the edges of the
+ * frontier are more than 1 / ALPHA of the edges of the unvisited vertices,
+ * and left again when the frontier shrinks below n / BETA vertices.
+ * Visited vertices are kept in a bitmap for both directions, so the
+ * unvisited ones are found a word at a time. The search stops after the
+ * level that reaches @target.
+ *
+ * Return:      minimum distance between target and source vertices, -1 if
+ *              @target is -1 or unreachable
+ */
+int bfs_hybrid(int source, int target, int **adj_list, int n, int *edge_count, int *dist)
+{
+    int words = (n + 63) / 64;
+    uint64_t *visited = calloc(words + 1, sizeof(uint64_t));
+    uint64_t *frontier_bits = calloc(words + 1, sizeof(uint64_t));
+    uint64_t *next_bits = calloc(words + 1, sizeof(uint64_t));
+    int *frontier = malloc(n * sizeof(int));
+    int *next = malloc(n * sizeof(int));
+
+    long long int edges_left = 0;
+    for (int i = 0; i < n; ++i) {
+        dist[i] = -1;
+        edges_left += edge_count[i];
+    }
+
+    dist[source] = 0;
+    visited[source / 64] |= 1ULL << (source % 64);
+    frontier[0] = source;
+    int count = 1;
+    long long int frontier_edges = edge_count[source];
+    bool bottom_up = false;
+    bool growing = true;
+
+    for (int level = 1; count > 0 && (target < 0 || dist[target] == -1); ++level) {
+        // edges_left counts the edges of the vertices not visited yet
+        edges_left -= frontier_edges;
+
+        if (!bottom_up && frontier_edges > edges_left / ALPHA) {
+            // the frontier array becomes a bitmap
+            memset(frontier_bits, 0, words * sizeof(uint64_t));
+            for (int i = 0; i < count; ++i) {
+                frontier_bits[frontier[i] / 64] |= 1ULL << (frontier[i] % 64);
+            }
+            bottom_up = true;
+        } else if (bottom_up && !growing && count < n / BETA) {
+            // the frontier bitmap becomes an array
+            count = 0;
+            for (int w = 0; w < words; ++w) {
+                for (uint64_t bits = frontier_bits[w]; bits; bits &= bits - 1) {
+                    frontier[count++] = w * 64 + __builtin_ctzll(bits);
+                }
+            }
+            bottom_up = false;
+        }
+
+        int last_count = count;
+        if (bottom_up) {
+            count = bottom_up_step(adj_list, edge_count, n, dist, visited,
+                                   frontier_bits, next_bits, level, &frontier_edges);
+            uint64_t *swap = frontier_bits;
+            frontier_bits = next_bits;
+            next_bits = swap;
+        } else {
+            count = top_down_step(adj_list, edge_count, dist, visited,
+                                  frontier, count, next, level, &frontier_edges);
+            int *swap = frontier;
+            frontier = next;
+            next = swap;
+        }
+        growing = count > last_count;
+    }
+
+    int source_target_min_distance = target < 0 ? -1 : dist[target];
+
+    // free memory
+    free(visited);
+    free(frontier_bits);
+    free(next_bits);
+    free(frontier);
+    free(next);
+
+    return source_target_min_distance;
+}
+
+/**
+ * top_down_step - visits the unvisited neighbours of the frontier
+ * @adj_list:   adjacency list representing undirected graph
+ * @edge_count: array keeping track of number of edges for a specific edge
+ * @dist:       the distances, set to @level for the new vertices
+ * @visited:    bitmap of the visited vertices
+ * @frontier:   the vertices at distance @level - 1
+ * @count:      number of vertices in @frontier
+ * @next:       the new vertices are stored here
+ * @level:      distance of the new vertices
+ * @next_edges: set to the number of edges of the new vertices
+ *
+ * Return:      number of vertices in @next
+ */
+int top_down_step(int **adj_list, int *edge_count, int *dist, uint64_t *visited,
+                  const int *frontier, int count, int *next, int level, long long int *next_edges)
+{
+    int rear = 0;
+    long long int edges = 0;
+    for (int i = 0; i < count; ++i) {
+        int current = frontier[i];
+        for (int j = 0; j < edge_count[current]; ++j) {
+            int neighbor = adj_list[current][j];
+            if (!(visited[neighbor / 64] >> (neighbor % 64) & 1)) {
+                visited[neighbor / 64] |= 1ULL << (neighbor % 64);
+                dist[neighbor] = level;
+                next[rear++] = neighbor;
+                edges += edge_count[neighbor];
+            }
+        }
+    }
+    *next_edges = edges;
+    return rear;
+}
+
+/**
+ * bottom_up_step - lets every unvisited vertex look for a parent
+ * @adj_list:   adjacency list representing undirected graph
+ * @edge_count: array keeping track of number of edges for a specific edge
+ * @n:          number of vertices
+ * @dist:       the distances, set to @level for the new vertices
+ * @visited:    bitmap of the visited vertices
+ * @frontier:   bitmap of the vertices at distance @level - 1
+ * @next:       bitmap that is filled with the new vertices
+ * @level:      distance of the new vertices
+ * @next_edges: set to the number of edges of the new vertices
+ *
+ * the scan of a vertex stops at its first neighbour in the frontier, so
+ * the edges between vertices that are already visited are never looked
+ * at. a vertex found in this step is not a parent in the same step, as
+ * the frontier bitmap is not changed.
+ *
+ * Return:      number of vertices in @next
+ */
+int bottom_up_step(int **adj_list, int *edge_count, int n, int *dist, uint64_t *visited,
+                   const uint64_t *frontier, uint64_t *next, int level, long long int *next_edges)
+{
+    int words = (n + 63) / 64;
+    int count = 0;
+    long long int edges = 0;
+    for (int w = 0; w < words; ++w) {
+        uint64_t unvisited = ~visited[w];
+        if (w == words - 1 && n % 64 != 0)
+            unvisited &= (1ULL << (n % 64)) - 1;
+        next[w] = 0;
+        for (; unvisited; unvisited &= unvisited - 1) {
+            int v = w * 64 + __builtin_ctzll(unvisited);
+            for (int j = 0; j < edge_count[v]; ++j) {
+                int neighbor = adj_list[v][j];
+                if (frontier[neighbor / 64] >> (neighbor % 64) & 1) {
+                    next[w] |= 1ULL << (v % 64);
+                    dist[v] = level;
+                    count++;
+                    edges += edge_count[v];
+                    break;
+                }
+            }
+        }
+        visited[w] |= next[w];
+    }
+    *next_edges = edges;
+    return count;
+}
+
 /**
  * enqueue - add a node to the queue
  * @q:    pointer to the queue data structure
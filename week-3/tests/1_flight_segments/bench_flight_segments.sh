@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# usage: ./bench_flight_segments.sh
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 ../../../week-3/flight_segments.c -Wall -lm -o bench.out &&
+
+# n connected vertices plus one isolated vertex n + 1 as the target, so
+# the search visits the whole graph. k edges per vertex, one end picked
+# in proportion to the degrees, which gives a low diameter and a few hubs
+generate_hubs() {
+    awk -v n="$1" -v k="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n + 1, (n - 1) * k
+        ends[0] = 1
+        e = 1
+        for (v = 2; v <= n; ++v) {
+            for (j = 0; j < k; ++j) {
+                if (rand() < 0.3)
+                    u = int((v - 1) * rand()) + 1
+                else
+                    u = ends[int(e * rand())]
+                print v, u
+                ends[e++] = u
+                ends[e++] = v
+            }
+        }
+        print 1, n + 1
+    }'
+}
+
+# n connected vertices and m random edges, target as above
+generate_random() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n + 1, m
+        for (i = 0; i < m; ++i) {
+            print int(n * rand()) + 1, int(n * rand()) + 1
+        }
+        print 1, n + 1
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_hubs 1000000 5 1 > "$tmp_dir/hubs"
+generate_random 1000000 10000000 2 > "$tmp_dir/random"
+
+for graph in hubs random
+do
+    echo "$(head -n 1 "$tmp_dir/$graph") $graph"
+    echo "    bfs: $(./bench.out --time < "$tmp_dir/$graph" 2>&1 >/dev/null)"
+    echo "    --hybrid: $(./bench.out --hybrid --time < "$tmp_dir/$graph" 2>&1 >/dev/null)"
+done
+
+rm -rf "$tmp_dir" bench.out
@@ -0,0 +1,459 @@
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define UNREACHED LLONG_MAX
+
+/* number of frontier vertices a thread takes at once */
+#define CHUNK_SIZE 64
+
+/*
+ * graph - directed graph with edge costs in CSR form
+ * @n:        number of vertices
+ * @m:        number of edges
+ * @first:    edges of u are head[first[u] .. first[u + 1] - 1]
+ * @head:     target of each edge
+ * @cost:     cost of each edge
+ * @max_cost: the largest edge cost
+ */
+struct graph {
+    int n;
+    int m;
+    int *first;
+    int *head;
+    int *cost;
+    int max_cost;
+};
+
+/*
+ * bucket - growable list of vertices
+ */
+struct bucket {
+    int count;
+    int capacity;
+    int *vertices;
+};
+
+struct delta_stepping;
+
+/*
+ * worker - the thread-local state of a delta-stepping thread
+ * @id:       index of the thread
+ * @D:        the shared state
+ * @buckets:  D->slots buckets used circularly, bucket i holds the
+ *            vertices with distance in [i * delta, (i + 1) * delta)
+ * @frontier: the vertices of the current bucket this thread inserted,
+ *            processed by all threads during a light phase
+ * @settled:  the vertices this thread removed from the current bucket,
+ *            whose heavy edges are relaxed once the bucket is empty
+ */
+struct worker {
+    int id;
+    struct delta_stepping *D;
+    struct bucket *buckets;
+    struct bucket frontier;
+    struct bucket settled;
+};
+
+/*
+ * delta_stepping - state shared by the delta-stepping threads
+ * @G:            the graph
+ * @delta:        the bucket width, edges with cost <= @delta are light
+ * @slots:        number of buckets kept by each thread, enough to hold
+ *                every distance between current and current + max_cost
+ * @thread_count: number of threads
+ * @distance:     tentative distance of each vertex, UNREACHED if none
+ * @workers:      the thread-local states
+ * @barrier:      synchronizes the phases
+ * @current:      index of the bucket being emptied
+ * @done:         set when every bucket is empty
+ * @phase_done:   set when a light phase found the current bucket empty
+ * @offset:       start of each worker's frontier in the joint frontier
+ * @total:        size of the joint frontier
+ * @next:         next unclaimed position of the joint frontier
+ *
+ * The fields after @barrier are written by thread 0 between two
+ * barriers and only read by the others.
+ */
+struct delta_stepping {
+    struct graph *G;
+    long long int delta;
+    int slots;
+    int thread_count;
+    _Atomic long long int *distance;
+    struct worker *workers;
+    pthread_barrier_t barrier;
+    long long int current;
+    bool done;
+    bool phase_done;
+    int *offset;
+    int total;
+    atomic_int next;
+};
+
+/* function prototypes */
+struct graph *read_graph(int *source);
+void free_graph(struct graph *G);
+long long int *delta_stepping(struct graph *G, int source, long long int delta, int thread_count);
+void *delta_worker(void *arg);
+bool atomic_min(_Atomic long long int *target, long long int value);
+void bucket_push(struct bucket *b, int v);
+
+/*
+ * usage:
+ *     ./a.out [--threads=<t>] [--delta=<d>] [--time] < graph
+ *
+ * The input is the same as for minimum_flight_cost.c, the source is the
+ * first vertex of the last line. The distance to every vertex is printed
+ * on its own line, -1 for the unreachable ones.
+ *
+ *     --threads=<t> number of threads (default: number of online cpus)
+ *     --delta=<d>   bucket width (default: max cost / average out-degree)
+ *     --time        print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
+{
+    int thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    long long int delta = 0;
+    bool print_time = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+        } else if (strncmp(argv[i], "--delta=", 8) == 0) {
+            delta = atoll(argv[i] + 8);
+            if (delta <= 0) {
+                fprintf(stderr, "invalid delta: %s\n", argv[i] + 8);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (thread_count < 1)
+        thread_count = 1;
+
+    int source;
+    struct graph *G = read_graph(&source);
+
+    // the width suggested by Meyer and Sanders for random edge costs: a
+    // vertex then has about one light edge, while the buckets stay wide
+    // enough to give every thread work
+    if (delta == 0) {
+        delta = G->n > 0 ? (long long int)G->max_cost * G->n / (G->m > 0 ? G->m : 1) : 1;
+        if (delta < 1)
+            delta = 1;
+    }
+
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    long long int *distance = delta_stepping(G, source, delta, thread_count);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+
+    for (int v = 0; v < G->n; ++v) {
+        printf("%lld\n", distance[v] == UNREACHED ? -1 : distance[v]);
+    }
+    if (print_time) {
+        fprintf(stderr, "%d threads, delta %lld: %.3f ms\n", thread_count, delta,
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
+
+    free(distance);
+    free_graph(G);
+    return 0;
+}
+
+/**
+ * read_graph - reads the graph and the source vertex
+ *
+ * @source: set to the 0-based source vertex
+ *
+ * The edges are read into flat arrays first and then placed into the
+ * CSR arrays with a counting pass, so no list is reallocated per edge.
+ *
+ * Return: pointer to the graph
+ */
+struct graph *read_graph(int *source)
+{
+    struct graph *G = malloc(sizeof(struct graph));
+    if (scanf("%d %d", &G->n, &G->m) != 2) {
+        G->n = G->m = 0;
+    }
+
+    int *tail = malloc(G->m * sizeof(int));
+    int *head = malloc(G->m * sizeof(int));
+    int *cost = malloc(G->m * sizeof(int));
+    G->first = calloc(G->n + 1, sizeof(int));
+    G->max_cost = 0;
+    for (int i = 0; i < G->m; ++i) {
+        scanf("%d %d %d", &tail[i], &head[i], &cost[i]);
+        tail[i]--;
+        head[i]--;
+        G->first[tail[i] + 1]++;
+        if (cost[i] > G->max_cost)
+            G->max_cost = cost[i];
+    }
+
+    *source = 1;
+    scanf("%d", source);
+    (*source)--;
+
+    for (int u = 0; u < G->n; ++u) {
+        G->first[u + 1] += G->first[u];
+    }
+    G->head = malloc(G->m * sizeof(int));
+    G->cost = malloc(G->m * sizeof(int));
+    int *fill = malloc(G->n * sizeof(int));
+    memcpy(fill, G->first, G->n * sizeof(int));
+    for (int i = 0; i < G->m; ++i) {
+        int position = fill[tail[i]]++;
+        G->head[position] = head[i];
+        G->cost[position] = cost[i];
+    }
+
+    free(fill);
+    free(tail);
+    free(head);
+    free(cost);
+    return G;
+}
+
+void free_graph(struct graph *G)
+{
+    free(G->first);
+    free(G->head);
+    free(G->cost);
+    free(G);
+}
+
+/**
+ * delta_stepping - single-source shortest paths with delta-stepping
+ *
+ * @G:            the graph, edge costs must be non-negative
+ * @source:       the source vertex
+ * @delta:        the bucket width
+ * @thread_count: number of threads
+ *
+ * Vertices are kept in buckets of width @delta. The lowest non-empty
+ * bucket is emptied in light phases: the threads share its vertices and
+ * relax their light edges (cost <= @delta), which may put vertices back
+ * into the same bucket. When it stays empty, the heavy edges of the
+ * removed vertices are relaxed once, since they can only reach later
+ * buckets. Distances are lowered with a lock-free atomic minimum and
+ * every thread inserts into its own buckets, so a phase needs no locks.
+ *
+ * Return: the distance array, UNREACHED for the unreachable vertices
+ */
+long long int *delta_stepping(struct graph *G, int source, long long int delta, int thread_count)
+{
+    struct delta_stepping D;
+    D.G = G;
+    D.delta = delta;
+    D.slots = G->max_cost / delta + 2;
+    D.thread_count = thread_count;
+    D.distance = malloc(G->n * sizeof(_Atomic long long int));
+    D.workers = calloc(thread_count, sizeof(struct worker));
+    D.offset = malloc((thread_count + 1) * sizeof(int));
+    D.current = 0;
+    D.done = false;
+    D.phase_done = false;
+    D.total = 0;
+    atomic_init(&D.next, 0);
+    pthread_barrier_init(&D.barrier, NULL, thread_count);
+
+    for (int v = 0; v < G->n; ++v) {
+        atomic_init(&D.distance[v], UNREACHED);
+    }
+    for (int i = 0; i < thread_count; ++i) {
+        D.workers[i].id = i;
+        D.workers[i].D = &D;
+        D.workers[i].buckets = calloc(D.slots, sizeof(struct bucket));
+    }
+    if (source >= 0 && source < G->n) {
+        atomic_store(&D.distance[source], 0);
+        bucket_push(&D.workers[0].buckets[0], source);
+    }
+
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int i = 1; i < thread_count; ++i) {
+        pthread_create(&threads[i], NULL, delta_worker, &D.workers[i]);
+    }
+    delta_worker(&D.workers[0]);
+    for (int i = 1; i < thread_count; ++i) {
+        pthread_join(threads[i], NULL);
+    }
+
+    long long int *distance = malloc(G->n * sizeof(long long int));
+    for (int v = 0; v < G->n; ++v) {
+        distance[v] = atomic_load(&D.distance[v]);
+    }
+
+    for (int i = 0; i < thread_count; ++i) {
+        for (int j = 0; j < D.slots; ++j) {
+            free(D.workers[i].buckets[j].vertices);
+        }
+        free(D.workers[i].buckets);
+        free(D.workers[i].frontier.vertices);
+        free(D.workers[i].settled.vertices);
+    }
+    pthread_barrier_destroy(&D.barrier);
+    free(threads);
+    free(D.workers);
+    free(D.offset);
+    free(D.distance);
+    return distance;
+}
+
+/**
+ * relax_edges - relaxes the light or the heavy edges of a vertex
+ *
+ * @W:     the worker, improved vertices go to its buckets
+ * @u:     the vertex
+ * @d:     the distance of @u
+ * @light: relax the edges with cost <= delta if true, the others if false
+ */
+void relax_edges(struct worker *W, int u, long long int d, bool light)
+{
+    struct delta_stepping *D = W->D;
+    struct graph *G = D->G;
+    for (int i = G->first[u]; i < G->first[u + 1]; ++i) {
+        if ((G->cost[i] <= D->delta) != light)
+            continue;
+        int v = G->head[i];
+        long long int curr_dist = d + G->cost[i];
+        if (atomic_min(&D->distance[v], curr_dist))
+            bucket_push(&W->buckets[(curr_dist / D->delta) % D->slots], v);
+    }
+}
+
+/**
+ * delta_worker - the loop run by every delta-stepping thread
+ *
+ * @arg: the worker
+ *
+ * All threads go through the same sequence of barriers. Thread 0 makes
+ * the decisions (frontier offsets, end of a phase, next bucket) between
+ * two barriers, the other threads read them after the second one.
+ *
+ * Return: NULL
+ */
+void *delta_worker(void *arg)
+{
+    struct worker *W = arg;
+    struct delta_stepping *D = W->D;
+
+    for (;;) {
+        int slot = D->current % D->slots;
+
+        // light phases until the current bucket stays empty
+        for (;;) {
+            struct bucket temp = W->frontier;
+            W->frontier = W->buckets[slot];
+            W->buckets[slot] = temp;
+            W->buckets[slot].count = 0;
+            pthread_barrier_wait(&D->barrier);
+
+            if (W->id == 0) {
+                D->offset[0] = 0;
+                for (int i = 0; i < D->thread_count; ++i) {
+                    D->offset[i + 1] = D->offset[i] + D->workers[i].frontier.count;
+                }
+                D->total = D->offset[D->thread_count];
+                D->phase_done = D->total == 0;
+                atomic_store(&D->next, 0);
+            }
+            pthread_barrier_wait(&D->barrier);
+            if (D->phase_done)
+                break;
+
+            int start;
+            while ((start = atomic_fetch_add(&D->next, CHUNK_SIZE)) < D->total) {
+                int end = start + CHUNK_SIZE < D->total ? start + CHUNK_SIZE : D->total;
+                int part = 0;
+                for (int k = start; k < end; ++k) {
+                    while (k >= D->offset[part + 1]) {
+                        part++;
+                    }
+                    int u = D->workers[part].frontier.vertices[k - D->offset[part]];
+                    long long int d = atomic_load_explicit(&D->distance[u], memory_order_relaxed);
+
+                    // skip the entries left behind when u moved to a lower bucket
+                    if (d / D->delta != D->current)
+                        continue;
+                    bucket_push(&W->settled, u);
+                    relax_edges(W, u, d, true);
+                }
+            }
+            pthread_barrier_wait(&D->barrier);
+        }
+
+        // the distances in the current bucket are final, relax the heavy edges
+        for (int i = 0; i < W->settled.count; ++i) {
+            int u = W->settled.vertices[i];
+            relax_edges(W, u, atomic_load_explicit(&D->distance[u], memory_order_relaxed), false);
+        }
+        W->settled.count = 0;
+        pthread_barrier_wait(&D->barrier);
+
+        if (W->id == 0) {
+            D->done = true;
+            for (int k = 1; k < D->slots && D->done; ++k) {
+                int next_slot = (D->current + k) % D->slots;
+                for (int i = 0; i < D->thread_count; ++i) {
+                    if (D->workers[i].buckets[next_slot].count > 0) {
+                        D->current += k;
+                        D->done = false;
+                        break;
+                    }
+                }
+            }
+        }
+        pthread_barrier_wait(&D->barrier);
+        if (D->done)
+            break;
+    }
+    return NULL;
+}
+
+/**
+ * atomic_min - lowers @target to @value if @value is smaller
+ *
+ * @target: the atomic distance
+ * @value:  the new distance
+ *
+ * Return: true if @target was lowered
+ */
+bool atomic_min(_Atomic long long int *target, long long int value)
+{
+    long long int old = atomic_load_explicit(target, memory_order_relaxed);
+    while (value < old) {
+        if (atomic_compare_exchange_weak_explicit(target, &old, value, memory_order_relaxed, memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+/**
+ * bucket_push - appends a vertex to a bucket
+ *
+ * @b: the bucket
+ * @v: the vertex
+ */
+void bucket_push(struct bucket *b, int v)
+{
+    if (b->count == b->capacity) {
+        b->capacity = b->capacity ? 2 * b->capacity : 16;
+        b->vertices = realloc(b->vertices, b->capacity * sizeof(int));
+    }
+    b->vertices[b->count++] = v;
+}
@@ -1,6 +1,12 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
 
 #define INFINITY 1000000
 
@@ -8,14 +14,98 @@ struct vertex {
     int dist;
 };
 
+/*
+ * spt - shortest path tree kept by the queue-based bellman-ford
+ * @parent: parent of each vertex, -1 if the vertex is not in the tree
+ * @depth:  depth of each vertex, the virtual root n has depth 0
+ * @next:   successor of each vertex in the preorder of the tree
+ * @prev:   predecessor of each vertex in the preorder of the tree
+ *
+ * The preorder is a circular list through the virtual root n, so the
+ * subtree of v is v followed by the vertices deeper than v.
+ */
+struct spt {
+    int *parent;
+    int *depth;
+    int *next;
+    int *prev;
+};
+
+/*
+ * parallel_bf - state shared by the bellman-ford threads
+ * @adj, @cost, @edge_count, @n: the graph
+ * @thread_count: number of threads
+ * @split:        thread i relaxes the edges of vertices split[i] .. split[i + 1] - 1
+ * @dist:         distance of each vertex, lowered with an atomic minimum
+ * @changed:      set by any thread that lowered a distance in this pass
+ * @barrier:      separates the passes
+ * @done:         set by thread 0 when the passes are over
+ * @cycle:        set by thread 0 when the last pass still changed something
+ */
+struct parallel_bf {
+    int **adj;
+    int **cost;
+    int *edge_count;
+    int n;
+    int thread_count;
+    int *split;
+    _Atomic long long int *dist;
+    atomic_bool changed;
+    pthread_barrier_t barrier;
+    bool done;
+    bool cycle;
+};
+
+/*
+ * bf_worker - a bellman-ford thread
+ * @id: index of the thread
+ * @P:  the shared state
+ */
+struct bf_worker {
+    int id;
+    struct parallel_bf *P;
+};
 
 /* function prototypes */
 struct vertex *initialize_single_source (int n, int s);
 bool negative_cycle(int **adj, int **cost, int *edge_count, int n);
-void relax(struct vertex *vertices, int u_idx, int v_idx, int weight);
+bool negative_cycle_passes(int **adj, int **cost, int *edge_count, int n);
+bool negative_cycle_parallel(int **adj, int **cost, int *edge_count, int n, int thread_count);
+void *bf_worker(void *arg);
+bool atomic_min(_Atomic long long int *target, long long int value);
+bool disassemble_subtree(struct spt *T, int v, int u);
+bool relax(struct vertex *vertices, int u_idx, int v_idx, int weight);
 
-int main(void)
+/*
+ * usage:
+ *     ./a.out [--passes] [--threads=<t>] [--time] < graph
+ *
+ *     --passes       use the pass-based bellman-ford instead of the queue
+ *     --threads=<t>  run the passes on t threads
+ *     --time         print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
 {
+    bool passes = false;
+    bool print_time = false;
+    int thread_count = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--passes") == 0) {
+            passes = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     // get # of edge and # of vertex
     int n, m;
     scanf("%d %d", &n, &m);
@@ -41,7 +131,21 @@ int main(void)
     }
     
     // print the result.
-    printf("%d\n", negative_cycle(adj_list, cost, edge_count, n));
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    bool cycle;
+    if (thread_count > 0)
+        cycle = negative_cycle_parallel(adj_list, cost, edge_count, n, thread_count);
+    else if (passes)
+        cycle = negative_cycle_passes(adj_list, cost, edge_count, n);
+    else
+        cycle = negative_cycle(adj_list, cost, edge_count, n);
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    printf("%d\n", cycle);
+    if (print_time) {
+        fprintf(stderr, "%.3f ms\n",
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
 
     // free allocated memory
     for (int i = 0; i < n; ++i) {
@@ -62,26 +166,159 @@ int main(void)
  * @edge_count: array counting the number of edges of adj, and cost
  * @n: the number of vertices
  *
+ * queue-based bellman-ford: every vertex starts at distance 0, as if a
+ * virtual root reached each of them with a zero edge, and only the
+ * vertices whose distance changed are scanned again. the shortest path
+ * tree is kept as a preorder list. when v improves, its subtree is
+ * removed from the tree (its distances are outdated), and if the
+ * improving vertex u was in that subtree, the tree path from v to u
+ * plus the edge (u, v) is a negative cycle. the search stops when the
+ * queue is empty, so graphs without negative cycles take far fewer
+ * than n - 1 passes.
+ *
+ * Return: true, if graph contains a negative cycle, false otherwise
+ */
+bool negative_cycle(int **adj, int **cost, int *edge_count, int n)
+{
+    struct vertex *vertices = initialize_single_source(n, 0);
+    struct spt T;
+    T.parent = malloc((n + 1) * sizeof(int));
+    T.depth = malloc((n + 1) * sizeof(int));
+    T.next = malloc((n + 1) * sizeof(int));
+    T.prev = malloc((n + 1) * sizeof(int));
+    int *queue = malloc(n * sizeof(int));
+    bool *in_queue = malloc(n * sizeof(bool));
+
+    // every vertex is a child of the virtual root n and in the queue
+    for (int i = 0; i <= n; ++i) {
+        T.parent[i] = n;
+        T.depth[i] = 1;
+        T.next[i] = (i + 1) % (n + 1);
+        T.prev[(i + 1) % (n + 1)] = i;
+    }
+    T.depth[n] = 0;
+    for (int i = 0; i < n; ++i) {
+        vertices[i].dist = 0;
+        queue[i] = i;
+        in_queue[i] = true;
+    }
+
+    // circular queue, each vertex is in it at most once
+    int head = 0, size = n;
+    bool cycle = false;
+    while (size > 0 && !cycle) {
+        int u = queue[head];
+        head = (head + 1) % n;
+        size--;
+        in_queue[u] = false;
+
+        // removed from the tree, it is scanned again once it improves
+        if (T.parent[u] == -1)
+            continue;
+
+        for (int j = 0; j < edge_count[u] && !cycle; ++j) {
+            int v = adj[u][j];
+            if (vertices[v].dist <= vertices[u].dist + cost[u][j])
+                continue;
+            vertices[v].dist = vertices[u].dist + cost[u][j];
+
+            if (disassemble_subtree(&T, v, u)) {
+                cycle = true;
+                break;
+            }
+
+            // v becomes the first child of u
+            T.parent[v] = u;
+            T.depth[v] = T.depth[u] + 1;
+            T.next[v] = T.next[u];
+            T.prev[T.next[u]] = v;
+            T.next[u] = v;
+            T.prev[v] = u;
+
+            if (!in_queue[v]) {
+                queue[(head + size) % n] = v;
+                size++;
+                in_queue[v] = true;
+            }
+        }
+    }
+
+    free(vertices);
+    free(T.parent);
+    free(T.depth);
+    free(T.next);
+    free(T.prev);
+    free(queue);
+    free(in_queue);
+    return cycle;
+}
+
+/**
+ * disassemble_subtree - removes the subtree of a vertex from the tree
+ *
+ * @T: the shortest path tree
+ * @v: root of the subtree, it may already be out of the tree
+ * @u: the vertex whose edge improved @v
+ *
+ * the descendants of @v are marked as out of the tree, @v itself is
+ * unlinked so it can be attached to @u.
+ *
+ * Return: true, if @u is in the subtree (a negative cycle), false otherwise
+ */
+bool disassemble_subtree(struct spt *T, int v, int u)
+{
+    if (T->parent[v] == -1)
+        return false;
+    if (v == u)
+        return true;
+
+    int before = T->prev[v];
+    int x = T->next[v];
+    while (T->depth[x] > T->depth[v]) {
+        if (x == u)
+            return true;
+        T->parent[x] = -1;
+        x = T->next[x];
+    }
+    T->next[before] = x;
+    T->prev[x] = before;
+    return false;
+}
+
+/**
+ * negative_cycle_passes - detects the negative weighted cycle
+ * 
+ * @adj: adjacency list
+ * @cost: cost list 
+ * @edge_count: array counting the number of edges of adj, and cost
+ * @n: the number of vertices
+ *
  * uses bellman-ford algorithm to detect the shortest path by
  * choosing the source vertex as the 0th vertex and running
  * |G.V|-1 times while doing relaxation for each vertex. it
- * also run one more time additionally for detecting the
- * negative weighted cycle and return true if there is, return
- * false if there is no negative weighted cycle.
+ * stops early when a pass changes nothing, since then no later
+ * pass can. otherwise it runs one more time additionally for
+ * detecting the negative weighted cycle and return true if there
+ * is, return false if there is no negative weighted cycle.
  *
  * Return: true, if graph contains a negative cycle, false otherwise
  */
-bool negative_cycle(int **adj, int **cost, int *edge_count, int n)
+bool negative_cycle_passes(int **adj, int **cost, int *edge_count, int n)
 {
     struct vertex *vertices = initialize_single_source(n, 0);
     // run |G.V| - 1 times
     for (int k = 0; k < n - 1; ++k) {
+        bool changed = false;
         // for each edge G.E (requires two inner for loop)
         for (int i = 0; i < n; ++i) {
             for (int j = 0; j < edge_count[i]; ++j) {
-                relax(vertices, i, adj[i][j], cost[i][j]);
+                changed |= relax(vertices, i, adj[i][j], cost[i][j]);
             }
         }
+        if (!changed) {
+            free(vertices);
+            return false;
+        }
     }
 
     // run |V|th time for detecting the negative weight cycle
@@ -99,6 +336,131 @@ bool negative_cycle(int **adj, int **cost, int *edge_count, int n)
     return false;
 }
 
+/**
+ * negative_cycle_parallel - detects the negative weighted cycle on threads
+ *
+ * @adj: adjacency list
+ * @cost: cost list
+ * @edge_count: array counting the number of edges of adj, and cost
+ * @n: the number of vertices
+ * @thread_count: the number of threads
+ *
+ * pass-based bellman-ford where every vertex starts at distance 0, as
+ * in negative_cycle(). the vertices are split into ranges holding about
+ * the same number of edges, one per thread, and the distances are
+ * lowered with a lock-free atomic minimum. a pass ends at a barrier,
+ * the search stops when a pass changes nothing, and a change in pass n
+ * means a negative cycle.
+ *
+ * Return: true, if graph contains a negative cycle, false otherwise
+ */
+bool negative_cycle_parallel(int **adj, int **cost, int *edge_count, int n, int thread_count)
+{
+    struct parallel_bf P;
+    P.adj = adj;
+    P.cost = cost;
+    P.edge_count = edge_count;
+    P.n = n;
+    P.thread_count = thread_count;
+    P.split = malloc((thread_count + 1) * sizeof(int));
+    P.dist = malloc(n * sizeof(_Atomic long long int));
+    P.done = n == 0;
+    P.cycle = false;
+    atomic_init(&P.changed, false);
+    pthread_barrier_init(&P.barrier, NULL, thread_count);
+
+    long long int m = 0;
+    for (int i = 0; i < n; ++i) {
+        atomic_init(&P.dist[i], 0);
+        m += edge_count[i];
+    }
+
+    // thread t starts at the first vertex after t * m / thread_count edges
+    long long int seen = 0;
+    int u = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        while (u < n && seen + edge_count[u] <= t * m / thread_count) {
+            seen += edge_count[u++];
+        }
+        P.split[t] = t == 0 ? 0 : u;
+    }
+    P.split[thread_count] = n;
+
+    struct bf_worker *workers = malloc(thread_count * sizeof(struct bf_worker));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 0; t < thread_count; ++t) {
+        workers[t].id = t;
+        workers[t].P = &P;
+    }
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, bf_worker, &workers[t]);
+    }
+    bf_worker(&workers[0]);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_barrier_destroy(&P.barrier);
+    free(threads);
+    free(workers);
+    free(P.split);
+    free(P.dist);
+    return P.cycle;
+}
+
+/**
+ * bf_worker - the passes run by every bellman-ford thread
+ *
+ * @arg: the worker
+ *
+ * Return: NULL
+ */
+void *bf_worker(void *arg)
+{
+    struct bf_worker *W = arg;
+    struct parallel_bf *P = W->P;
+
+    for (int k = 0; !P->done; ++k) {
+        bool changed = false;
+        for (int i = P->split[W->id]; i < P->split[W->id + 1]; ++i) {
+            long long int d = atomic_load_explicit(&P->dist[i], memory_order_relaxed);
+            for (int j = 0; j < P->edge_count[i]; ++j) {
+                changed |= atomic_min(&P->dist[P->adj[i][j]], d + P->cost[i][j]);
+            }
+        }
+        if (changed)
+            atomic_store_explicit(&P->changed, true, memory_order_relaxed);
+        pthread_barrier_wait(&P->barrier);
+
+        if (W->id == 0) {
+            bool any = atomic_load_explicit(&P->changed, memory_order_relaxed);
+            atomic_store_explicit(&P->changed, false, memory_order_relaxed);
+            P->cycle = any && k == P->n - 1;
+            P->done = !any || k == P->n - 1;
+        }
+        pthread_barrier_wait(&P->barrier);
+    }
+    return NULL;
+}
+
+/**
+ * atomic_min - lowers @target to @value if @value is smaller
+ *
+ * @target: the atomic distance
+ * @value: the new distance
+ *
+ * Return: true, if @target was lowered
+ */
+bool atomic_min(_Atomic long long int *target, long long int value)
+{
+    long long int old = atomic_load_explicit(target, memory_order_relaxed);
+    while (value < old) {
+        if (atomic_compare_exchange_weak_explicit(target, &old, value, memory_order_relaxed, memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
 /**
  * relax - do relaxation between given vertices
  * 
@@ -106,12 +468,16 @@ bool negative_cycle(int **adj, int **cost, int *edge_count, int n)
  * @u_idx: the index of the source vertex
  * @v_idx: the index of the target vertex
  * @weight: the weight between source and target vertex
+ *
+ * Return: true, if the distance of the target vertex decreased
  */
-void relax(struct vertex *vertices, int u_idx, int v_idx, int weight)
+bool relax(struct vertex *vertices, int u_idx, int v_idx, int weight)
 {
     if (vertices[v_idx].dist > vertices[u_idx].dist + weight) {
         vertices[v_idx].dist = vertices[u_idx].dist + weight;
+        return true;
     }
+    return false;
 }
 
 /**
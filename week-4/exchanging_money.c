@@ -1,6 +1,13 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdbool.h>
+#include <string.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
 
 #define INFINITY 1000000000000000000
 
@@ -19,8 +26,80 @@ struct graph {
     int *reachable;
 };
 
+/*
+ * parallel_bf - state shared by the bellman-ford threads
+ * @G:            the graph
+ * @thread_count: number of threads
+ * @split:        thread i relaxes the edges of vertices split[i] .. split[i + 1] - 1
+ * @distance:     distance of each vertex, lowered with an atomic minimum
+ * @changed:      set by any thread that lowered a distance in this round
+ * @barrier:      separates the rounds
+ * @done:         set by thread 0 when a round changed nothing
+ * @seeds:        vertices each thread found relaxable after the rounds
+ * @seed_count:   number of seeds of each thread
+ */
+struct parallel_bf {
+    struct graph *G;
+    int thread_count;
+    int *split;
+    _Atomic long long int *distance;
+    atomic_bool changed;
+    pthread_barrier_t barrier;
+    bool done;
+    int **seeds;
+    int *seed_count;
+};
+
+struct bf_worker {
+    int id;
+    struct parallel_bf *P;
+};
+
+/*
+ * johnson - state shared by the all-pairs threads
+ * @G:            the graph
+ * @sources:      the source vertices, answered in this order
+ * @source_count: number of sources
+ * @component:    strongly connected component of each vertex
+ * @negative:     true for the vertices of a component with a negative cycle
+ * @potential:    feasible potential of the other vertices
+ * @next_source:  next source not taken by a thread
+ * @printed:      number of sources already printed
+ * @lock:         protects @printed
+ * @turn:         signaled when @printed changes
+ */
+struct johnson {
+    struct graph *G;
+    int *sources;
+    int source_count;
+    int *component;
+    bool *negative;
+    long long int *potential;
+    atomic_int next_source;
+    int printed;
+    pthread_mutex_t lock;
+    pthread_cond_t turn;
+};
+
+/*
+ * heap_entry - entry of the lazy dijkstra heap
+ */
+struct heap_entry {
+    long long int dist;
+    int vertex;
+};
+
 /* function definitions */
 void free_memory(struct graph *G);
+void mark_reachable(struct graph *G, int *queue, int count, int *mark, int value);
+void shortest_path_parallel(struct graph *G, int thread_count);
+void *bf_worker(void *arg);
+bool atomic_min(_Atomic long long int *target, long long int value);
+void all_pairs(struct graph *G, int *sources, int source_count, int thread_count);
+int strongly_connected_components(struct graph *G, int *component);
+void *johnson_worker(void *arg);
+void single_source(struct johnson *J, struct graph *S, struct heap_entry **heap, int *capacity);
+void print_result(struct graph *G, FILE *out);
 
 struct graph *initialize_graph(int **adj, int **cost, int *edge_count, int n, int s)
 {
@@ -38,7 +117,6 @@ struct graph *initialize_graph(int **adj, int **cost, int *edge_count, int n, in
         G->shortest[i] = 1;
     }
     G->distance[s] = 0;
-    G->reachable[s] = 1;
     return G;
 }
 
@@ -53,49 +131,554 @@ bool relax(struct graph *G, int u_idx, int v_idx, int weight)
 
 void shortest_path(struct graph *G)
 {
-    // run |G.V| - 1  times
+    int *queue = malloc(G->n * sizeof(int));
+
+    // vertices reachable from the source
+    queue[0] = G->source;
+    mark_reachable(G, queue, 1, G->reachable, 1);
+
+    // run |G.V| - 1  times, unreachable vertices keep INFINITY
     for (int k = 0; k < G->n - 1; ++k) {
+        bool changed = false;
         // for each edge G.E (requires two inner for loop)
         for (int i = 0; i < G->n; ++i) {
+            if (!G->reachable[i])
+                continue;
             for (int j = 0; j < G->edge_count[i]; ++j) {
-                //printf("%d->%d: %d\n", i, G->adj[i][j], G->cost[i][j]);
-                relax(G, i, G->adj[i][j], G->cost[i][j]);
-                if (G->reachable[i]) {
-                    G->reachable[G->adj[i][j]] = 1;
-                }
+                changed |= relax(G, i, G->adj[i][j], G->cost[i][j]);
             }
         }
-        //printf("round %d is completed\n", k + 1);
+        if (!changed)
+            break;
     }
 
-    // detecting vertices inside the negative loop
-    for (int k = 0; k < G->n; ++k) {
-        for (int i = 0; i < G->n; ++i) {
+    // one more round, the vertices still relaxable are reached by a
+    // negative cycle, and so is everything reachable from them
+    int count = 0;
+    for (int i = 0; i < G->n; ++i) {
+        if (!G->reachable[i])
+            continue;
+        for (int j = 0; j < G->edge_count[i]; ++j) {
+            int v_idx = G->adj[i][j];
+            if (relax(G, i, v_idx, G->cost[i][j]) && G->shortest[v_idx]) {
+                G->shortest[v_idx] = 0;
+                queue[count++] = v_idx;
+            }
+        }
+    }
+    mark_reachable(G, queue, count, G->shortest, 0);
+
+    free(queue);
+}
+
+/*
+ * mark_reachable - breadth-first search from several vertices
+ *
+ * @G:     the graph
+ * @queue: array of G->n entries starting with the @count start vertices
+ * @count: number of start vertices
+ * @mark:  array set to @value for every vertex reached
+ * @value: the mark, vertices already holding it are not visited again
+ */
+void mark_reachable(struct graph *G, int *queue, int count, int *mark, int value)
+{
+    for (int i = 0; i < count; ++i) {
+        mark[queue[i]] = value;
+    }
+    for (int head = 0; head < count; ++head) {
+        int u = queue[head];
+        for (int j = 0; j < G->edge_count[u]; ++j) {
+            int v = G->adj[u][j];
+            if (mark[v] != value) {
+                mark[v] = value;
+                queue[count++] = v;
+            }
+        }
+    }
+}
+
+/*
+ * shortest_path_parallel - shortest_path() with the rounds on threads
+ *
+ * @G:            the graph
+ * @thread_count: number of threads
+ *
+ * the vertices are split into ranges holding about the same number of
+ * edges, one per thread. distances are lowered with a lock-free atomic
+ * minimum and the rounds stop early when none of the threads changed a
+ * distance. the vertices reached by a negative cycle do not depend on
+ * the order of the relaxations, so the output is the same as shortest_path().
+ */
+void shortest_path_parallel(struct graph *G, int thread_count)
+{
+    struct parallel_bf P;
+    P.G = G;
+    P.thread_count = thread_count;
+    P.split = malloc((thread_count + 1) * sizeof(int));
+    P.distance = malloc(G->n * sizeof(_Atomic long long int));
+    P.done = false;
+    P.seeds = malloc(thread_count * sizeof(int *));
+    P.seed_count = calloc(thread_count, sizeof(int));
+    atomic_init(&P.changed, false);
+    pthread_barrier_init(&P.barrier, NULL, thread_count);
+
+    int *queue = malloc(G->n * sizeof(int));
+    queue[0] = G->source;
+    mark_reachable(G, queue, 1, G->reachable, 1);
+
+    long long int m = 0;
+    for (int i = 0; i < G->n; ++i) {
+        atomic_init(&P.distance[i], G->distance[i]);
+        m += G->edge_count[i];
+    }
+
+    // thread t starts at the first vertex after t * m / thread_count edges,
+    // each of its edges gives at most one seed
+    long long int seen = 0;
+    int u = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        long long int start = seen;
+        while (u < G->n && seen + G->edge_count[u] <= (t + 1) * m / thread_count) {
+            seen += G->edge_count[u++];
+        }
+        if (t == thread_count - 1) {
+            while (u < G->n) {
+                seen += G->edge_count[u++];
+            }
+        }
+        P.split[t + 1] = u;
+        P.seeds[t] = malloc((seen - start + 1) * sizeof(int));
+    }
+    P.split[0] = 0;
+
+    struct bf_worker *workers = malloc(thread_count * sizeof(struct bf_worker));
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 0; t < thread_count; ++t) {
+        workers[t].id = t;
+        workers[t].P = &P;
+    }
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, bf_worker, &workers[t]);
+    }
+    bf_worker(&workers[0]);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    for (int i = 0; i < G->n; ++i) {
+        G->distance[i] = atomic_load(&P.distance[i]);
+    }
+    int count = 0;
+    for (int t = 0; t < thread_count; ++t) {
+        for (int i = 0; i < P.seed_count[t]; ++i) {
+            int v_idx = P.seeds[t][i];
+            if (G->shortest[v_idx]) {
+                G->shortest[v_idx] = 0;
+                queue[count++] = v_idx;
+            }
+        }
+        free(P.seeds[t]);
+    }
+    mark_reachable(G, queue, count, G->shortest, 0);
+
+    pthread_barrier_destroy(&P.barrier);
+    free(queue);
+    free(threads);
+    free(workers);
+    free(P.split);
+    free(P.distance);
+    free(P.seeds);
+    free(P.seed_count);
+}
+
+/*
+ * bf_worker - the rounds run by every bellman-ford thread
+ *
+ * @arg: the worker
+ *
+ * Return: NULL
+ */
+void *bf_worker(void *arg)
+{
+    struct bf_worker *W = arg;
+    struct parallel_bf *P = W->P;
+    struct graph *G = P->G;
+    int lo = P->split[W->id], hi = P->split[W->id + 1];
+
+    for (int k = 0; k < G->n - 1 && !P->done; ++k) {
+        bool changed = false;
+        for (int i = lo; i < hi; ++i) {
+            if (!G->reachable[i])
+                continue;
+            long long int d = atomic_load_explicit(&P->distance[i], memory_order_relaxed);
             for (int j = 0; j < G->edge_count[i]; ++j) {
-                //printf("%d->%d: %d\n", i, G->adj[i][j], G->cost[i][j]);
-                if (relax(G, i, G->adj[i][j], G->cost[i][j])){
+                changed |= atomic_min(&P->distance[G->adj[i][j]], d + G->cost[i][j]);
+            }
+        }
+        if (changed)
+            atomic_store_explicit(&P->changed, true, memory_order_relaxed);
+        pthread_barrier_wait(&P->barrier);
+
+        if (W->id == 0) {
+            P->done = !atomic_load_explicit(&P->changed, memory_order_relaxed);
+            atomic_store_explicit(&P->changed, false, memory_order_relaxed);
+        }
+        pthread_barrier_wait(&P->barrier);
+    }
+
+    // one more round, collecting the vertices still relaxable
+    for (int i = lo; i < hi; ++i) {
+        if (!G->reachable[i])
+            continue;
+        long long int d = atomic_load_explicit(&P->distance[i], memory_order_relaxed);
+        for (int j = 0; j < G->edge_count[i]; ++j) {
+            if (atomic_min(&P->distance[G->adj[i][j]], d + G->cost[i][j]))
+                P->seeds[W->id][P->seed_count[W->id]++] = G->adj[i][j];
+        }
+    }
+    return NULL;
+}
+
+bool atomic_min(_Atomic long long int *target, long long int value)
+{
+    long long int old = atomic_load_explicit(target, memory_order_relaxed);
+    while (value < old) {
+        if (atomic_compare_exchange_weak_explicit(target, &old, value, memory_order_relaxed, memory_order_relaxed))
+            return true;
+    }
+    return false;
+}
+
+/*
+ * all_pairs - answers many sources with johnson's algorithm
+ *
+ * @G:            the graph
+ * @sources:      the source vertices
+ * @source_count: number of sources
+ * @thread_count: number of threads running the dijkstras
+ *
+ * a negative cycle lies inside one strongly connected component, so
+ * bellman-ford over the edges inside the components finds the
+ * components with a negative cycle, and a second one over the edges
+ * between the other vertices gives a feasible potential. for each
+ * source, the vertices reachable from a negative component reachable
+ * from the source are "-", and dijkstra with the reweighted costs
+ * cost + potential[u] - potential[v] >= 0 gives the other distances,
+ * since their shortest paths avoid the negative components. the
+ * sources are shared by the threads and each answer is printed as
+ * soon as the answers of the sources before it are.
+ */
+void all_pairs(struct graph *G, int *sources, int source_count, int thread_count)
+{
+    struct johnson J;
+    J.G = G;
+    J.sources = sources;
+    J.source_count = source_count;
+    J.component = malloc(G->n * sizeof(int));
+    J.negative = calloc(G->n, sizeof(bool));
+    J.potential = calloc(G->n, sizeof(long long int));
+    J.printed = 0;
+    atomic_init(&J.next_source, 0);
+    pthread_mutex_init(&J.lock, NULL);
+    pthread_cond_init(&J.turn, NULL);
+
+    int component_count = strongly_connected_components(G, J.component);
+    bool *negative_component = calloc(component_count, sizeof(bool));
+
+    // every vertex starts at potential 0, as if a virtual root reached
+    // each of them with a zero edge. the first rounds only use the
+    // edges inside the components, the second ones the edges between
+    // vertices of components without a negative cycle.
+    for (int pass = 0; pass < 2; ++pass) {
+        for (int k = 0; k < G->n; ++k) {
+            bool changed = false;
+            for (int i = 0; i < G->n; ++i) {
+                if (J.negative[i])
+                    continue;
+                for (int j = 0; j < G->edge_count[i]; ++j) {
                     int v_idx = G->adj[i][j];
-                    G->shortest[v_idx] = 0;
+                    if (pass == 0 ? J.component[v_idx] != J.component[i] : J.negative[v_idx])
+                        continue;
+                    if (J.potential[v_idx] > J.potential[i] + G->cost[i][j]) {
+                        J.potential[v_idx] = J.potential[i] + G->cost[i][j];
+                        changed = true;
+                        // still relaxable in round n, a negative cycle
+                        if (k == G->n - 1)
+                            negative_component[J.component[v_idx]] = true;
+                    }
                 }
             }
+            if (!changed)
+                break;
+        }
+        for (int i = 0; i < G->n; ++i) {
+            J.negative[i] = negative_component[J.component[i]];
         }
     }
+
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_create(&threads[t], NULL, johnson_worker, &J);
+    }
+    johnson_worker(&J);
+    for (int t = 1; t < thread_count; ++t) {
+        pthread_join(threads[t], NULL);
+    }
+
+    pthread_mutex_destroy(&J.lock);
+    pthread_cond_destroy(&J.turn);
+    free(threads);
+    free(negative_component);
+    free(J.component);
+    free(J.negative);
+    free(J.potential);
 }
 
-void print_result(struct graph *G)
+/*
+ * johnson_worker - answers sources until none is left
+ *
+ * @arg: the shared state
+ *
+ * Return: NULL
+ */
+void *johnson_worker(void *arg)
+{
+    struct johnson *J = arg;
+    struct graph *G = J->G;
+    struct graph *S = initialize_graph(G->adj, G->cost, G->edge_count, G->n, 0);
+    struct heap_entry *heap = NULL;
+    int capacity = 0;
+
+    int k;
+    while ((k = atomic_fetch_add(&J->next_source, 1)) < J->source_count) {
+        S->source = J->sources[k];
+        single_source(J, S, &heap, &capacity);
+
+        char *text;
+        size_t size;
+        FILE *out = open_memstream(&text, &size);
+        print_result(S, out);
+        fclose(out);
+
+        // wait until the sources before this one are printed
+        pthread_mutex_lock(&J->lock);
+        while (J->printed != k) {
+            pthread_cond_wait(&J->turn, &J->lock);
+        }
+        fwrite(text, 1, size, stdout);
+        J->printed++;
+        pthread_cond_broadcast(&J->turn);
+        pthread_mutex_unlock(&J->lock);
+        free(text);
+    }
+
+    free(heap);
+    free(S->distance);
+    free(S->shortest);
+    free(S->reachable);
+    free(S);
+    return NULL;
+}
+
+/*
+ * single_source - fills the result arrays of one source
+ *
+ * @J:        the shared state
+ * @S:        the graph with the result arrays of this thread
+ * @heap:     the dijkstra heap of this thread, grown as needed
+ * @capacity: the capacity of @heap
+ */
+void single_source(struct johnson *J, struct graph *S, struct heap_entry **heap, int *capacity)
+{
+    int *queue = malloc(S->n * sizeof(int));
+    for (int i = 0; i < S->n; ++i) {
+        S->distance[i] = INFINITY;
+        S->shortest[i] = 1;
+        S->reachable[i] = 0;
+    }
+
+    queue[0] = S->source;
+    mark_reachable(S, queue, 1, S->reachable, 1);
+    int count = 0;
+    for (int i = 0; i < S->n; ++i) {
+        if (S->reachable[i] && J->negative[i])
+            queue[count++] = i;
+    }
+    mark_reachable(S, queue, count, S->shortest, 0);
+    free(queue);
+    if (J->negative[S->source])
+        return;
+
+    // lazy binary heap on the reweighted distances
+    long long int *potential = J->potential;
+    int size = 1;
+    if (*capacity == 0) {
+        *capacity = 16;
+        *heap = malloc(*capacity * sizeof(struct heap_entry));
+    }
+    S->distance[S->source] = 0;
+    (*heap)[0] = (struct heap_entry){0, S->source};
+    while (size > 0) {
+        struct heap_entry top = (*heap)[0];
+        struct heap_entry last = (*heap)[--size];
+        int i = 0;
+        while (2 * i + 1 < size) {
+            int c = 2 * i + 1;
+            if (c + 1 < size && (*heap)[c + 1].dist < (*heap)[c].dist)
+                c++;
+            if (last.dist <= (*heap)[c].dist)
+                break;
+            (*heap)[i] = (*heap)[c];
+            i = c;
+        }
+        (*heap)[i] = last;
+
+        int u = top.vertex;
+        if (top.dist > S->distance[u])
+            continue;
+        for (int j = 0; j < S->edge_count[u]; ++j) {
+            int v = S->adj[u][j];
+            if (J->negative[v])
+                continue;
+            long long int d = top.dist + S->cost[u][j] + potential[u] - potential[v];
+            if (d >= S->distance[v])
+                continue;
+            S->distance[v] = d;
+            if (size == *capacity) {
+                *capacity *= 2;
+                *heap = realloc(*heap, *capacity * sizeof(struct heap_entry));
+            }
+            i = size++;
+            while (i > 0 && (*heap)[(i - 1) / 2].dist > d) {
+                (*heap)[i] = (*heap)[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            (*heap)[i] = (struct heap_entry){d, v};
+        }
+    }
+
+    // back to the original costs
+    for (int v = 0; v < S->n; ++v) {
+        if (S->distance[v] != INFINITY)
+            S->distance[v] += potential[v] - potential[S->source];
+    }
+}
+
+/*
+ * strongly_connected_components - iterative tarjan's algorithm
+ *
+ * @G:         the graph
+ * @component: set to the component of each vertex
+ *
+ * Return: number of components
+ */
+int strongly_connected_components(struct graph *G, int *component)
+{
+    int *index = malloc(G->n * sizeof(int));
+    int *low = malloc(G->n * sizeof(int));
+    int *next_edge = malloc(G->n * sizeof(int));
+    int *call_stack = malloc(G->n * sizeof(int));
+    int *stack = malloc(G->n * sizeof(int));
+    bool *on_stack = calloc(G->n, sizeof(bool));
+    for (int i = 0; i < G->n; ++i) {
+        index[i] = -1;
+    }
+
+    int counter = 0, count = 0, top = 0;
+    for (int r = 0; r < G->n; ++r) {
+        if (index[r] != -1)
+            continue;
+        int depth = 0;
+        call_stack[depth++] = r;
+        index[r] = low[r] = counter++;
+        next_edge[r] = 0;
+        stack[top++] = r;
+        on_stack[r] = true;
+        while (depth > 0) {
+            int u = call_stack[depth - 1];
+            if (next_edge[u] < G->edge_count[u]) {
+                int v = G->adj[u][next_edge[u]++];
+                if (index[v] == -1) {
+                    index[v] = low[v] = counter++;
+                    next_edge[v] = 0;
+                    stack[top++] = v;
+                    on_stack[v] = true;
+                    call_stack[depth++] = v;
+                } else if (on_stack[v] && index[v] < low[u]) {
+                    low[u] = index[v];
+                }
+                continue;
+            }
+
+            // u is finished, pop its component if it is the root
+            depth--;
+            if (depth > 0 && low[u] < low[call_stack[depth - 1]])
+                low[call_stack[depth - 1]] = low[u];
+            if (low[u] == index[u]) {
+                int v;
+                do {
+                    v = stack[--top];
+                    on_stack[v] = false;
+                    component[v] = count;
+                } while (v != u);
+                count++;
+            }
+        }
+    }
+
+    free(index);
+    free(low);
+    free(next_edge);
+    free(call_stack);
+    free(stack);
+    free(on_stack);
+    return count;
+}
+
+void print_result(struct graph *G, FILE *out)
 {
     for (int i = 0; i < G->n; ++i) {
         if (G->reachable[i] == 0)
-            printf("%c\n", '*');
+            fprintf(out, "%c\n", '*');
         else if (G->shortest[i] == 0)
-            printf("%c\n", '-');
+            fprintf(out, "%c\n", '-');
         else
-            printf("%lld\n", G->distance[i]);
+            fprintf(out, "%lld\n", G->distance[i]);
     }
 }
 
-int main(void)
+/*
+ * usage:
+ *     ./a.out [--threads=<t>] [--johnson] [--time] < graph
+ *
+ *     --threads=<t>  run the bellman-ford rounds on t threads, or the
+ *                    dijkstras with --johnson (default: one per cpu)
+ *     --johnson      read sources until the end of the input and print
+ *                    the result of each, in order, with johnson's algorithm
+ *     --time         print the time of the search to stderr
+ */
+int main(int argc, char *argv[])
 {
+    int thread_count = 0;
+    bool johnson = false;
+    bool print_time = false;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--johnson") == 0) {
+            johnson = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
     int n, m;
     scanf("%d %d", &n, &m);
 
@@ -117,14 +700,38 @@ int main(void)
         edge_count[a]++;
     }
 
+    // a single source, or every remaining number with --johnson
+    int source_count = 0;
+    int *sources = malloc(sizeof(int));
     int source;
-    scanf("%d", &source);
-    source--;
+    while (scanf("%d", &source) == 1) {
+        sources = realloc(sources, (source_count + 1) * sizeof(int));
+        sources[source_count++] = source - 1;
+        if (!johnson)
+            break;
+    }
 
-    struct graph *G = initialize_graph(adj_list, cost, edge_count, n, source);
-    shortest_path(G);
-    print_result(G);
+    struct graph *G = initialize_graph(adj_list, cost, edge_count, n, sources[0]);
+    struct timespec start, end;
+    clock_gettime(CLOCK_MONOTONIC, &start);
+    if (johnson) {
+        if (thread_count == 0)
+            thread_count = (int)sysconf(_SC_NPROCESSORS_ONLN);
+        all_pairs(G, sources, source_count, thread_count > 0 ? thread_count : 1);
+    } else {
+        if (thread_count > 0)
+            shortest_path_parallel(G, thread_count);
+        else
+            shortest_path(G);
+        print_result(G, stdout);
+    }
+    clock_gettime(CLOCK_MONOTONIC, &end);
+    if (print_time) {
+        fprintf(stderr, "%.3f ms\n",
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
 
+    free(sources);
     free_memory(G);
     return 0;
 }
@@ -1,33 +1,396 @@
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <limits.h>
 
-#define HEAP_SIZE_MAX 100000
 #define INFINITY 1000000000
 
+/* backend used by --queue when no name is given, override with -DQUEUE_BACKEND='"dial"' */
+#ifndef QUEUE_BACKEND
+#define QUEUE_BACKEND "binary"
+#endif
+
+#define RADIX_BUCKETS 65
+
+/* settled vertex limits of the witness searches during contraction */
+#define CH_WITNESS_LIMIT 500
+#define CH_SIMULATE_LIMIT 50
+#define CH_FILE_MAGIC 0x31304843 /* "CH01" */
+
+/* default number of landmarks of --alt */
+#define ALT_LANDMARKS 8
+
 struct vertex {
     int index;
     long long int dist;
 };
 
+/*
+ * min_heap - indexed binary min heap
+ * @heap_size: number of vertices currently in the heap
+ * @H:         heap array of vertices ordered by dist
+ * @pos:       maps a vertex index to its position in @H, -1 if extracted
+ */
 struct min_heap {
     int heap_size;
-    struct vertex H[HEAP_SIZE_MAX];
+    struct vertex *H;
+    int *pos;
+};
+
+/*
+ * queue_ops - a priority queue backend used by dijkstra_queue()
+ * @name:    the name used to select the backend with --queue=<name>
+ * @create:  allocates a queue for @n vertices whose edge costs are
+ *           non-negative and at most @max_cost
+ * @push:    inserts vertex @v with key @d, or lowers its key if @v is
+ *           already queued
+ * @pop:     removes a vertex having the minimum key and stores the key
+ *           in @d, returns -1 if the queue is empty
+ * @clear:   removes every entry, in time proportional to the entries
+ * @destroy: frees the queue
+ *
+ * Backends that do not support decrease-key (lazy, radix) insert a new
+ * entry on every push. dijkstra_queue() skips the stale entries.
+ */
+struct queue_ops {
+    const char *name;
+    void *(*create)(int n, int max_cost);
+    void (*push)(void *q, int v, long long int d);
+    int (*pop)(void *q, long long int *d);
+    void (*clear)(void *q);
+    void (*destroy)(void *q);
+};
+
+/* entry of the 4-ary heap, four of them fill one 64 byte cache line */
+struct heap_entry {
+    long long int dist;
+    int index;
+};
+
+/*
+ * quaternary_heap - indexed 4-ary min heap
+ * @heap_size: number of vertices currently in the heap
+ * @H:         64 byte aligned entry array, heap position i is stored
+ *             at H[i + 3] so the four children of a node share a line
+ * @pos:       maps a vertex index to its heap position, -1 if absent
+ */
+struct quaternary_heap {
+    int heap_size;
+    struct heap_entry *H;
+    int *pos;
+};
+
+/*
+ * pairing_heap - pairing heap with one node per vertex
+ * @root:    the vertex at the root, -1 if the heap is empty
+ * @key:     key of each vertex
+ * @child:   leftmost child of each vertex
+ * @sibling: right sibling of each vertex
+ * @prev:    left sibling, or parent for the leftmost child
+ * @queued:  true while the vertex is in the heap
+ * @pairs:   scratch array used by the two-pass merge in pop
+ */
+struct pairing_heap {
+    int root;
+    long long int *key;
+    int *child;
+    int *sibling;
+    int *prev;
+    bool *queued;
+    int *pairs;
+};
+
+/*
+ * lazy_heap - binary heap without decrease-key
+ * @heap_size: number of entries in the heap
+ * @capacity:  allocated number of entries
+ * @H:         heap array, a vertex may appear several times
+ */
+struct lazy_heap {
+    int heap_size;
+    int capacity;
+    struct heap_entry *H;
+};
+
+/*
+ * dial_queue - Dial's bucket queue for small integer costs
+ * @size:    number of queued vertices
+ * @buckets: number of buckets (max_cost + 1), used circularly
+ * @current: the last extracted key, no queued key is smaller
+ * @head:    first vertex of each bucket, -1 if empty
+ * @next:    next vertex in the same bucket
+ * @prev:    previous vertex in the same bucket
+ * @key:     key of each vertex, -1 if not queued
+ */
+struct dial_queue {
+    int size;
+    int buckets;
+    long long int current;
+    int *head;
+    int *next;
+    int *prev;
+    long long int *key;
+};
+
+/*
+ * radix_heap - monotone radix heap
+ * @size:     number of entries in the heap
+ * @last:     the last extracted key
+ * @count:    number of entries per bucket
+ * @capacity: allocated entries per bucket
+ * @bucket:   bucket i holds keys whose highest bit differing from
+ *            @last is bit i - 1, bucket 0 holds keys equal to @last
+ */
+struct radix_heap {
+    int size;
+    unsigned long long int last;
+    int count[RADIX_BUCKETS];
+    int capacity[RADIX_BUCKETS];
+    struct heap_entry *bucket[RADIX_BUCKETS];
+};
+
+/*
+ * search_state - buffers of dijkstra_queue() kept between queries
+ * @ops:      the priority queue backend
+ * @Q:        the priority queue, empty between queries
+ * @n:        number of vertices
+ * @version:  stamp of the current query
+ * @reached:  @distance[v] is valid only if reached[v] == @version
+ * @settled:  v is settled in the current query if settled[v] == @version
+ * @distance: tentative distance of each reached vertex
+ * @settled_count: number of vertices settled by queries so far
+ *
+ * Starting a new query only increments @version, so the cost of a query
+ * depends on the vertices it touches and not on @n.
+ */
+struct search_state {
+    const struct queue_ops *ops;
+    void *Q;
+    int n;
+    unsigned int version;
+    unsigned int *reached;
+    unsigned int *settled;
+    long long int *distance;
+    long long int settled_count;
+};
+
+/*
+ * ch_edge_list - growable edge list of a vertex during contraction
+ * @count:    number of edges
+ * @capacity: allocated number of edges
+ * @head:     target (or source for incoming lists) of each edge
+ * @cost:     cost of each edge
+ */
+struct ch_edge_list {
+    int count;
+    int capacity;
+    int *head;
+    long long int *cost;
+};
+
+/*
+ * hierarchy - a contraction hierarchy in CSR form
+ * @n:         number of vertices
+ * @rank:      contraction order of each vertex
+ * @fwd_first: edges of u in the forward upward graph are
+ *             fwd_head[fwd_first[u] .. fwd_first[u + 1] - 1]
+ * @fwd_head:  target of each forward upward edge u -> v
+ * @fwd_cost:  cost of each forward upward edge
+ * @bwd_first: the same for the backward upward graph, which holds
+ * @bwd_head:  each edge u -> v with rank[u] > rank[v] at vertex v,
+ * @bwd_cost:  pointing back to u
+ *
+ * Both graphs only lead from a vertex to vertices of higher rank, the
+ * shortcuts added during contraction are included.
+ */
+struct hierarchy {
+    int n;
+    int *rank;
+    int *fwd_first;
+    int *fwd_head;
+    long long int *fwd_cost;
+    int *bwd_first;
+    int *bwd_head;
+    long long int *bwd_cost;
+};
+
+/*
+ * landmarks - distance tables of the ALT (A*, landmarks, triangle
+ *             inequality) search
+ * @count:     number of landmarks
+ * @n:         number of vertices
+ * @vertex:    the landmark vertices
+ * @from:      from[k * n + v] is the distance from landmark k to v
+ * @to:        to[k * n + v] is the distance from v to landmark k
+ * @potential: lower bound of the distance to the target, cached per
+ *             query for the vertices reached by the search
+ *
+ * Unreachable pairs are stored as -1.
+ */
+struct landmarks {
+    int count;
+    int n;
+    int *vertex;
+    long long int *from;
+    long long int *to;
+    long long int *potential;
 };
 
 /* function prototypes */
 long long int dijkstra(int **adj, int **cost, int *edges, int s, int t, int n);
+long long int dijkstra_queue(const struct queue_ops *ops, int **adj, int **cost, int *edges, int s, int t, int n, int max_cost);
+struct search_state *init_search_state(const struct queue_ops *ops, int n, int max_cost);
+void free_search_state(struct search_state *S);
+long long int dijkstra_search(struct search_state *S, int **adj, int **cost, int *edges, int s, int t);
+const struct queue_ops *find_queue_ops(const char *name);
+struct hierarchy *ch_build(int **adj, int **cost, int *edges, int n, int max_cost);
+long long int ch_query(struct hierarchy *H, struct search_state *F, struct search_state *B, int s, int t);
+int ch_save(struct hierarchy *H, const char *path);
+struct hierarchy *ch_load(const char *path);
+void free_hierarchy(struct hierarchy *H);
+void ch_answer_queries(struct hierarchy *H, int **adj, int **cost, int *edges, bool print_time);
+int **reverse_adj_list(int **adj, int *edges, int *incoming_edge_count, int n);
+int **reverse_cost_list(int **adj, int **cost, int *edges, int n);
+long long int bidirectional_search(struct search_state *F, struct search_state *B, int **adj, int **cost, int *edges, int **radj, int **rcost, int *redges, int s, int t);
+struct landmarks *alt_preprocess(struct search_state *S, int **adj, int **cost, int *edges, int **radj, int **rcost, int *redges, int n, int count);
+long long int alt_search(struct search_state *S, struct landmarks *L, int **adj, int **cost, int *edges, int s, int t);
+void free_landmarks(struct landmarks *L);
 struct vertex extract_min(struct min_heap *h);
 void decrease_key(struct min_heap *Q, int v, long long int d);
 long long int dist(struct min_heap *Q, int j);
 void sift_up(struct min_heap *h, int i);
 void sift_down(struct min_heap *h, int i);
 struct min_heap *init_min_heap(int n);
+void free_min_heap(struct min_heap *h);
 void build_min_heap(struct min_heap *h);
 struct min_heap *initialize_single_sources(int n, int source);
-void swap(struct vertex *a, struct vertex *b);
+void swap(struct min_heap *h, int i, int j);
+void *binary_create(int n, int max_cost);
+void binary_push(void *q, int v, long long int d);
+int binary_pop(void *q, long long int *d);
+void binary_clear(void *q);
+void binary_destroy(void *q);
+void *quaternary_create(int n, int max_cost);
+void quaternary_push(void *q, int v, long long int d);
+int quaternary_pop(void *q, long long int *d);
+void quaternary_clear(void *q);
+void quaternary_destroy(void *q);
+void *pairing_create(int n, int max_cost);
+void pairing_push(void *q, int v, long long int d);
+int pairing_pop(void *q, long long int *d);
+void pairing_clear(void *q);
+void pairing_destroy(void *q);
+void *lazy_create(int n, int max_cost);
+void lazy_push(void *q, int v, long long int d);
+int lazy_pop(void *q, long long int *d);
+void lazy_clear(void *q);
+void lazy_destroy(void *q);
+void *dial_create(int n, int max_cost);
+void dial_push(void *q, int v, long long int d);
+int dial_pop(void *q, long long int *d);
+void dial_clear(void *q);
+void dial_destroy(void *q);
+void *radix_create(int n, int max_cost);
+void radix_push(void *q, int v, long long int d);
+int radix_pop(void *q, long long int *d);
+void radix_clear(void *q);
+void radix_destroy(void *q);
+
+static const struct queue_ops queue_backends[] = {
+    {"binary", binary_create, binary_push, binary_pop, binary_clear, binary_destroy},
+    {"4ary", quaternary_create, quaternary_push, quaternary_pop, quaternary_clear, quaternary_destroy},
+    {"pairing", pairing_create, pairing_push, pairing_pop, pairing_clear, pairing_destroy},
+    {"lazy", lazy_create, lazy_push, lazy_pop, lazy_clear, lazy_destroy},
+    {"dial", dial_create, dial_push, dial_pop, dial_clear, dial_destroy},
+    {"radix", radix_create, radix_push, radix_pop, radix_clear, radix_destroy},
+};
 
-int main(void)
+/*
+ * usage:
+ *     ./a.out                  answer with dijkstra() and the indexed binary heap
+ *     ./a.out --queue[=<name>] answer with dijkstra_queue() and the named backend
+ *                              (binary, 4ary, pairing, lazy, dial, radix)
+ *     ./a.out --multi          build the graph once, then answer every
+ *                              "s t" line until the end of the input
+ *     ./a.out --ch             contract the graph, then answer every "s t"
+ *                              line with the bidirectional upward search
+ *     ./a.out --ch-build=<f>   like --ch, and also write the hierarchy to <f>
+ *     ./a.out --ch=<f>         load the hierarchy from <f>, the input then
+ *                              only holds "s t" lines
+ *     ./a.out --bidir          like --multi, with the bidirectional search
+ *     ./a.out --alt[=<k>]      like --multi, with A* on the lower bounds of
+ *                              <k> landmarks (ALT_LANDMARKS by default)
+ *     ./a.out --check          with the modes answering many queries, compare
+ *                              every answer with dijkstra() and report
+ *                              mismatches to stderr
+ *     ./a.out --time           also print the search time to stderr
+ */
+int main(int argc, char *argv[])
 {
+    const struct queue_ops *ops = NULL;
+    bool print_time = false;
+    bool multi_query = false;
+    bool contract = false;
+    bool check = false;
+    bool bidirectional = false;
+    int landmark_count = 0;
+    const char *ch_file = NULL;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--queue") == 0) {
+            ops = find_queue_ops(QUEUE_BACKEND);
+        } else if (strncmp(argv[i], "--queue=", 8) == 0) {
+            ops = find_queue_ops(argv[i] + 8);
+            if (ops == NULL) {
+                fprintf(stderr, "unknown queue backend: %s\n", argv[i] + 8);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--multi") == 0) {
+            multi_query = true;
+        } else if (strcmp(argv[i], "--ch") == 0) {
+            contract = true;
+        } else if (strncmp(argv[i], "--ch-build=", 11) == 0) {
+            contract = true;
+            ch_file = argv[i] + 11;
+        } else if (strncmp(argv[i], "--ch=", 5) == 0) {
+            ch_file = argv[i] + 5;
+        } else if (strcmp(argv[i], "--bidir") == 0) {
+            bidirectional = true;
+        } else if (strcmp(argv[i], "--alt") == 0) {
+            landmark_count = ALT_LANDMARKS;
+        } else if (strncmp(argv[i], "--alt=", 6) == 0) {
+            landmark_count = atoi(argv[i] + 6);
+            if (landmark_count <= 0) {
+                fprintf(stderr, "invalid number of landmarks: %s\n", argv[i] + 6);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--check") == 0) {
+            check = true;
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    // A* keys grow by more than one edge cost per step, out of dial's range
+    if (landmark_count > 0 && (ops != NULL ? ops : find_queue_ops(QUEUE_BACKEND))->pop == dial_pop) {
+        fprintf(stderr, "the dial queue cannot be used with --alt\n");
+        return 1;
+    }
+
+    // answer the queries from a serialized hierarchy, there is no graph
+    if (ch_file != NULL && !contract) {
+        struct hierarchy *H = ch_load(ch_file);
+        if (H == NULL)
+            return 1;
+        ch_answer_queries(H, NULL, NULL, NULL, print_time);
+        free_hierarchy(H);
+        return 0;
+    }
+
     int n, m;
     scanf("%d %d", &n, &m);
 
@@ -36,9 +399,12 @@ int main(void)
     int *edge_count = calloc(n , sizeof(int));
 
     int a, b, w;
+    int max_cost = 0;
     for (int i = 0; i < m; ++i) {
         scanf("%d %d %d", &a, &b, &w);
         a--; b--;
+        if (w > max_cost)
+            max_cost = w;
         adj_list[a] = realloc(adj_list[a], (edge_count[a] + 1) * sizeof(int));
         adj_list[a][edge_count[a]] = b;
 
@@ -49,9 +415,105 @@ int main(void)
     }
 
     int s, t;
-    scanf("%d %d", &s, &t);
-    s--; t--;
-    printf("%lld\n", dijkstra(adj_list, flight_cost, edge_count, s, t, n));
+    int status = 0;
+    clock_t elapsed = 0;
+    if (contract) {
+        struct hierarchy *H = ch_build(adj_list, flight_cost, edge_count, n, max_cost);
+        if (ch_file != NULL && ch_save(H, ch_file) != 0) {
+            fprintf(stderr, "cannot write hierarchy: %s\n", ch_file);
+            status = 1;
+        } else {
+            // with --check, dijkstra() is the reference for every answer
+            ch_answer_queries(H, check ? adj_list : NULL, flight_cost, edge_count, print_time);
+        }
+        free_hierarchy(H);
+        print_time = false;
+    } else if (multi_query || bidirectional || landmark_count > 0) {
+        if (ops == NULL)
+            ops = find_queue_ops(QUEUE_BACKEND);
+        struct search_state *F = init_search_state(ops, n, max_cost);
+        struct search_state *B = NULL;
+        struct landmarks *L = NULL;
+
+        // the bidirectional search and the landmarks need the reversed graph
+        int *redges = NULL;
+        int **radj = NULL;
+        int **rcost = NULL;
+        if (bidirectional || landmark_count > 0) {
+            redges = calloc(n, sizeof(int));
+            radj = reverse_adj_list(adj_list, edge_count, redges, n);
+            rcost = reverse_cost_list(adj_list, flight_cost, edge_count, n);
+        }
+        if (bidirectional)
+            B = init_search_state(ops, n, max_cost);
+        else if (landmark_count > 0)
+            L = alt_preprocess(F, adj_list, flight_cost, edge_count, radj, rcost, redges, n, landmark_count);
+        F->settled_count = 0;
+
+        int queries = 0;
+        while (scanf("%d %d", &s, &t) == 2) {
+            s--; t--;
+            clock_t start = clock();
+            long long int result;
+            if (bidirectional)
+                result = bidirectional_search(F, B, adj_list, flight_cost, edge_count, radj, rcost, redges, s, t);
+            else if (L != NULL)
+                result = alt_search(F, L, adj_list, flight_cost, edge_count, s, t);
+            else
+                result = dijkstra_search(F, adj_list, flight_cost, edge_count, s, t);
+            elapsed += clock() - start;
+            queries++;
+            printf("%lld\n", result);
+
+            if (check) {
+                long long int expected = dijkstra(adj_list, flight_cost, edge_count, s, t, n);
+                if (expected != result) {
+                    fprintf(stderr, "mismatch for %d %d: %lld, dijkstra %lld\n",
+                            s + 1, t + 1, result, expected);
+                }
+            }
+        }
+
+        if (print_time) {
+            long long int settled = F->settled_count + (B != NULL ? B->settled_count : 0);
+            fprintf(stderr, "%s: %d queries, %.3f ms, %.1f settled vertices per query\n",
+                    bidirectional ? "bidir" : L != NULL ? "alt" : ops->name, queries,
+                    1000.0 * elapsed / CLOCKS_PER_SEC, queries ? (double)settled / queries : 0.0);
+            print_time = false;
+        }
+
+        if (radj != NULL) {
+            for (int i = 0; i < n; ++i) {
+                free(radj[i]);
+                free(rcost[i]);
+            }
+            free(radj);
+            free(rcost);
+            free(redges);
+        }
+        if (B != NULL)
+            free_search_state(B);
+        if (L != NULL)
+            free_landmarks(L);
+        free_search_state(F);
+    } else {
+        scanf("%d %d", &s, &t);
+        s--; t--;
+
+        clock_t start = clock();
+        long long int result;
+        if (ops == NULL)
+            result = dijkstra(adj_list, flight_cost, edge_count, s, t, n);
+        else
+            result = dijkstra_queue(ops, adj_list, flight_cost, edge_count, s, t, n, max_cost);
+        elapsed = clock() - start;
+        printf("%lld\n", result);
+    }
+
+    if (print_time) {
+        fprintf(stderr, "%s: %.3f ms\n", ops == NULL ? "dijkstra" : ops->name,
+                1000.0 * elapsed / CLOCKS_PER_SEC);
+    }
 
     // free the memory
     for (int i = 0; i < n; ++i) {
@@ -61,7 +523,7 @@ int main(void)
     free(adj_list);
     free(flight_cost);
     free(edge_count);
-    return 0;
+    return status;
 }
 
 /**
@@ -78,6 +540,7 @@ int main(void)
  * target vertex @t in a weighted graph represented by an adjacency list
  * and a cost matrix. The function returns the length of the shortest path.
  * If there is no path from the source to the target, the function returns -1.
+ * The search stops as soon as @t is extracted from the heap.
  *
  * Returns:
  * The length of the shortest path from @s to @t. If no path exists, returns -1.
@@ -94,6 +557,10 @@ long long int dijkstra(int **adj, int **cost, int *edges, int s, int t, int n)
         struct vertex u = extract_min(Q);
         distances[u.index] = u;
 
+        // the distance of t is final once it is extracted
+        if (u.index == t)
+            break;
+
         // process adjacent vertices of the vertex u
         for (int i = 0; i < edges[u.index]; ++i) {
             int adj_vertex_idx = adj[u.index][i];
@@ -120,11 +587,132 @@ long long int dijkstra(int **adj, int **cost, int *edges, int s, int t, int n)
 
     // free the allocated memory
     free(distances);
-    free(Q);
+    free_min_heap(Q);
+
+    return shortest_path;
+}
 
+/**
+ * dijkstra_queue - dijkstra() on top of a pluggable priority queue.
+ *
+ * @ops:      the priority queue backend.
+ * @adj:      adjacency list representing the graph.
+ * @cost:     cost matrix representing the weights of edges in the graph.
+ * @edges:    array representing the number of edges for each vertex.
+ * @s:        source vertex index.
+ * @t:        target vertex index.
+ * @n:        number of vertices in the graph.
+ * @max_cost: the largest edge cost, used to size the bucket queues.
+ *
+ * Allocates a search_state for a single query and runs dijkstra_search().
+ *
+ * Returns:
+ * The length of the shortest path from @s to @t. If no path exists, returns -1.
+ */
+long long int dijkstra_queue(const struct queue_ops *ops, int **adj, int **cost, int *edges, int s, int t, int n, int max_cost)
+{
+    struct search_state *S = init_search_state(ops, n, max_cost);
+    long long int shortest_path = dijkstra_search(S, adj, cost, edges, s, t);
+    free_search_state(S);
     return shortest_path;
 }
 
+/**
+ * dijkstra_search - answers one query with the buffers of @S.
+ *
+ * @S:     the search state, reused between queries.
+ * @adj:   adjacency list representing the graph.
+ * @cost:  cost matrix representing the weights of edges in the graph.
+ * @edges: array representing the number of edges for each vertex.
+ * @s:     source vertex index.
+ * @t:     target vertex index.
+ *
+ * Only the source is queued at the beginning, the other vertices are
+ * pushed when they are first reached. A popped entry whose key is larger
+ * than the known distance is stale (left behind by a lazy backend) and
+ * is skipped. The search stops once @t is extracted, and the entries
+ * still queued are cleared for the next query. If @t is -1, every
+ * vertex reachable from @s is settled and the distances stay in @S.
+ *
+ * Returns:
+ * The length of the shortest path from @s to @t. If no path exists, returns -1.
+ */
+long long int dijkstra_search(struct search_state *S, int **adj, int **cost, int *edges, int s, int t)
+{
+    // start a new query, reset the stamps only when the version wraps around
+    if (++S->version == 0) {
+        memset(S->reached, 0, S->n * sizeof(unsigned int));
+        memset(S->settled, 0, S->n * sizeof(unsigned int));
+        S->version = 1;
+    }
+    unsigned int version = S->version;
+
+    S->reached[s] = version;
+    S->distance[s] = 0;
+    S->ops->push(S->Q, s, 0);
+
+    long long int d;
+    int u;
+    while ((u = S->ops->pop(S->Q, &d)) != -1) {
+        // skip stale entries and vertices that are already settled
+        if (S->settled[u] == version || d > S->distance[u])
+            continue;
+        S->settled[u] = version;
+        S->settled_count++;
+        if (u == t)
+            break;
+
+        for (int i = 0; i < edges[u]; ++i) {
+            int v = adj[u][i];
+            long long int curr_dist = d + cost[u][i];
+            if (S->settled[v] == version)
+                continue;
+            if (S->reached[v] != version || curr_dist < S->distance[v]) {
+                S->reached[v] = version;
+                S->distance[v] = curr_dist;
+                S->ops->push(S->Q, v, curr_dist);
+            }
+        }
+    }
+    S->ops->clear(S->Q);
+
+    if (t == -1)
+        return -1;
+    return S->settled[t] == version ? S->distance[t] : -1;
+}
+
+/**
+ * init_search_state - allocates the buffers used by dijkstra_search()
+ *
+ * @ops:      the priority queue backend
+ * @n:        the total number of vertices in the graph
+ * @max_cost: the largest edge cost
+ *
+ * Return: pointer to the initialized search_state structure
+ */
+struct search_state *init_search_state(const struct queue_ops *ops, int n, int max_cost)
+{
+    struct search_state *S = malloc(sizeof(struct search_state));
+    S->ops = ops;
+    S->Q = ops->create(n, max_cost);
+    S->n = n;
+    S->version = 0;
+    S->reached = calloc(n, sizeof(unsigned int));
+    S->settled = calloc(n, sizeof(unsigned int));
+    S->distance = malloc(n * sizeof(long long int));
+    S->settled_count = 0;
+    return S;
+}
+
+void free_search_state(struct search_state *S)
+{
+    S->ops->destroy(S->Q);
+    free(S->reached);
+    free(S->settled);
+    free(S->distance);
+    free(S);
+}
+
 /**
  * extract_min - Extracts the minimum element from a min heap.
  *
@@ -138,8 +726,9 @@ long long int dijkstra(int **adj, int **cost, int *edges, int s, int t, int n)
 struct vertex extract_min(struct min_heap *h)
 {
     struct vertex min = h->H[0];
-    h->H[0] = h->H[h->heap_size - 1];
+    swap(h, 0, h->heap_size - 1);
     h->heap_size--;
+    h->pos[min.index] = -1;
     sift_down(h, 0);
     return min;
 }
@@ -157,16 +746,16 @@ struct vertex extract_min(struct min_heap *h)
  * maintained by performing a "sift_up" operation. Note that
  * decrease_key name is a bit misleading. It is used because of the
  * convention. The function actually update the dist value of a
- * specific vertex to a lower value.
+ * specific vertex to a lower value. The position of 'v' is looked
+ * up through Q->pos, so the whole operation is O(log n).
  */
 void decrease_key(struct min_heap *Q, int v, long long int d)
 {
-    for (int i = 0; i < Q->heap_size; ++i) {
-        if (Q->H[i].index == v) {
-            Q->H[i].dist = d;
-            sift_up(Q, i);
-        }
-    }
+    int i = Q->pos[v];
+    if (i == -1)
+        return;
+    Q->H[i].dist = d;
+    sift_up(Q, i);
 }
 
 /**
@@ -175,20 +764,18 @@ void decrease_key(struct min_heap *Q, int v, long long int d)
  * @Q: Pointer to the min_heap.
  * @j: The index of the vertex
  *
- * Linearly searches the distance value of a specified vertex with
- * the given index.
+ * Looks up the heap position of the vertex with the given index in
+ * the position map and returns its current distance in O(1).
  *
  * Return: the distance associated with the given index,
- *         or -1 if the index is not found.
+ *         or -1 if the vertex is no longer in the heap.
  */
 long long int dist(struct min_heap *Q, int j)
 {
-    for (int i = 0; i < Q->heap_size; ++i) {
-        if (Q->H[i].index == j) {
-            return Q->H[i].dist;
-        }
-    }
-    return -1;
+    int i = Q->pos[j];
+    if (i == -1)
+        return -1;
+    return Q->H[i].dist;
 }
 
 /**
@@ -211,6 +798,7 @@ struct min_heap *initialize_single_sources(int n, int source)
         a.index = i;
         a.dist = INFINITY;
         Q->H[i] = a;
+        Q->pos[i] = i;
     }
     Q->H[source].dist = 0;
     build_min_heap(Q);
@@ -221,7 +809,7 @@ void sift_up(struct min_heap *h, int i)
 {
     int parent = (i - 1) / 2;
     while (i > 0 && h->H[i].dist < h->H[parent].dist) {
-        swap(&h->H[i], &h->H[parent]);
+        swap(h, i, parent);
         i = parent;
         parent = (i - 1) / 2;
     }
@@ -229,35 +817,56 @@ void sift_up(struct min_heap *h, int i)
 
 void sift_down(struct min_heap *h, int i)
 {
-    // left child of ith element of the heap tree
-    int l = 2 * i + 1;
-    // right child of ith element of the heap tree
-    int r = 2 * i + 2;
+    for (;;) {
+        // left child of ith element of the heap tree
+        int l = 2 * i + 1;
+        // right child of ith element of the heap tree
+        int r = 2 * i + 2;
 
-    /*l is in the limits of the heap and child is smaller than its parent*/
-    int smallest;
-    if (l < h->heap_size && h->H[l].dist < h->H[i].dist)
-        smallest = l;
-    else
-        smallest = i;
+        /*l is in the limits of the heap and child is smaller than its parent*/
+        int smallest;
+        if (l < h->heap_size && h->H[l].dist < h->H[i].dist)
+            smallest = l;
+        else
+            smallest = i;
 
-    /*r is in the limits of the heap and child is smaller than its parent*/
-    if (r < h->heap_size && h->H[r].dist < h->H[smallest].dist)
-        smallest = r;
+        /*r is in the limits of the heap and child is smaller than its parent*/
+        if (r < h->heap_size && h->H[r].dist < h->H[smallest].dist)
+            smallest = r;
 
-    if (i != smallest) {
-        swap(&h->H[i], &h->H[smallest]);
-        sift_down(h, smallest);
+        if (i == smallest)
+            break;
+        swap(h, i, smallest);
+        i = smallest;
     }
 }
 
+/**
+ * init_min_heap - allocates an indexed min heap for @n vertices
+ *
+ * @n: the total number of vertices in the graph
+ *
+ * The heap array and the vertex-to-position map are sized from @n,
+ * so there is no fixed upper limit on the number of vertices.
+ *
+ * Return: pointer to the allocated min_heap structure
+ */
 struct min_heap *init_min_heap(int n)
 {
     struct min_heap *h = malloc(sizeof(struct min_heap));
     h->heap_size = n;
+    h->H = malloc(n * sizeof(struct vertex));
+    h->pos = malloc(n * sizeof(int));
     return h;
 }
 
+void free_min_heap(struct min_heap *h)
+{
+    free(h->H);
+    free(h->pos);
+    free(h);
+}
+
 void build_min_heap(struct min_heap *h)
 {
     for (int i = h->heap_size / 2; i >= 0; --i) {
@@ -265,10 +874,1461 @@ void build_min_heap(struct min_heap *h)
     }
 }
 
-void swap(struct vertex *a, struct vertex *b)
+/**
+ * swap - swaps two heap entries and keeps the position map in sync
+ *
+ * @h: Pointer to the min heap data structure.
+ * @i: heap position of the first entry
+ * @j: heap position of the second entry
+ */
+void swap(struct min_heap *h, int i, int j)
+{
+    struct vertex temp = h->H[i];
+    h->H[i] = h->H[j];
+    h->H[j] = temp;
+    h->pos[h->H[i].index] = i;
+    h->pos[h->H[j].index] = j;
+}
+
+
+/**
+ * find_queue_ops - looks up a priority queue backend by name
+ *
+ * @name: the backend name, e.g. "dial"
+ *
+ * Return: pointer to the backend, or NULL if there is no such backend
+ */
+const struct queue_ops *find_queue_ops(const char *name)
+{
+    int count = sizeof(queue_backends) / sizeof(queue_backends[0]);
+    for (int i = 0; i < count; ++i) {
+        if (strcmp(queue_backends[i].name, name) == 0)
+            return &queue_backends[i];
+    }
+    return NULL;
+}
+
+/*
+ * binary backend - the indexed struct min_heap used by dijkstra(), but
+ * starting empty and growing as vertices are reached.
+ */
+void *binary_create(int n, int max_cost)
+{
+    (void)max_cost;
+    struct min_heap *h = init_min_heap(n);
+    h->heap_size = 0;
+    for (int i = 0; i < n; ++i) {
+        h->pos[i] = -1;
+    }
+    return h;
+}
+
+void binary_push(void *q, int v, long long int d)
+{
+    struct min_heap *h = q;
+    if (h->pos[v] != -1) {
+        decrease_key(h, v, d);
+        return;
+    }
+    int i = h->heap_size++;
+    h->H[i].index = v;
+    h->H[i].dist = d;
+    h->pos[v] = i;
+    sift_up(h, i);
+}
+
+int binary_pop(void *q, long long int *d)
+{
+    struct min_heap *h = q;
+    if (h->heap_size == 0)
+        return -1;
+    struct vertex min = extract_min(h);
+    *d = min.dist;
+    return min.index;
+}
+
+void binary_clear(void *q)
+{
+    struct min_heap *h = q;
+    for (int i = 0; i < h->heap_size; ++i) {
+        h->pos[h->H[i].index] = -1;
+    }
+    h->heap_size = 0;
+}
+
+void binary_destroy(void *q)
+{
+    free_min_heap(q);
+}
+
+/*
+ * 4ary backend - indexed 4-ary heap. It is half as deep as the binary
+ * heap and sift_down() compares four children lying in one cache line.
+ */
+void quaternary_move(struct quaternary_heap *h, int i, struct heap_entry e)
+{
+    h->H[i + 3] = e;
+    h->pos[e.index] = i;
+}
+
+void quaternary_sift_up(struct quaternary_heap *h, int i)
+{
+    struct heap_entry e = h->H[i + 3];
+    while (i > 0) {
+        int parent = (i - 1) / 4;
+        if (h->H[parent + 3].dist <= e.dist)
+            break;
+        quaternary_move(h, i, h->H[parent + 3]);
+        i = parent;
+    }
+    quaternary_move(h, i, e);
+}
+
+void quaternary_sift_down(struct quaternary_heap *h, int i)
+{
+    struct heap_entry e = h->H[i + 3];
+    for (;;) {
+        int first = 4 * i + 1;
+        if (first >= h->heap_size)
+            break;
+        int last = first + 4 < h->heap_size ? first + 4 : h->heap_size;
+        int smallest = first;
+        for (int c = first + 1; c < last; ++c) {
+            if (h->H[c + 3].dist < h->H[smallest + 3].dist)
+                smallest = c;
+        }
+        if (h->H[smallest + 3].dist >= e.dist)
+            break;
+        quaternary_move(h, i, h->H[smallest + 3]);
+        i = smallest;
+    }
+    quaternary_move(h, i, e);
+}
+
+void *quaternary_create(int n, int max_cost)
+{
+    (void)max_cost;
+    struct quaternary_heap *h = malloc(sizeof(struct quaternary_heap));
+    // aligned_alloc() requires the size to be a multiple of the alignment
+    size_t bytes = (n + 3) * sizeof(struct heap_entry);
+    bytes = (bytes + 63) / 64 * 64;
+    h->H = aligned_alloc(64, bytes);
+    h->pos = malloc(n * sizeof(int));
+    h->heap_size = 0;
+    for (int i = 0; i < n; ++i) {
+        h->pos[i] = -1;
+    }
+    return h;
+}
+
+void quaternary_push(void *q, int v, long long int d)
+{
+    struct quaternary_heap *h = q;
+    int i = h->pos[v];
+    if (i == -1) {
+        i = h->heap_size++;
+        h->pos[v] = i;
+    }
+    h->H[i + 3].index = v;
+    h->H[i + 3].dist = d;
+    quaternary_sift_up(h, i);
+}
+
+int quaternary_pop(void *q, long long int *d)
+{
+    struct quaternary_heap *h = q;
+    if (h->heap_size == 0)
+        return -1;
+    struct heap_entry min = h->H[3];
+    h->heap_size--;
+    if (h->heap_size > 0) {
+        h->H[3] = h->H[h->heap_size + 3];
+        quaternary_sift_down(h, 0);
+    }
+    h->pos[min.index] = -1;
+    *d = min.dist;
+    return min.index;
+}
+
+void quaternary_clear(void *q)
+{
+    struct quaternary_heap *h = q;
+    for (int i = 0; i < h->heap_size; ++i) {
+        h->pos[h->H[i + 3].index] = -1;
+    }
+    h->heap_size = 0;
+}
+
+void quaternary_destroy(void *q)
+{
+    struct quaternary_heap *h = q;
+    free(h->H);
+    free(h->pos);
+    free(h);
+}
+
+/*
+ * pairing backend - pairing heap with a real decrease-key. A decreased
+ * vertex is cut from its parent together with its subtree and melded
+ * back at the root, which is O(1). pop() uses the two-pass merge.
+ */
+int pairing_meld(struct pairing_heap *h, int a, int b)
+{
+    if (a == -1)
+        return b;
+    if (b == -1)
+        return a;
+    if (h->key[b] < h->key[a]) {
+        int temp = a;
+        a = b;
+        b = temp;
+    }
+    // make b the leftmost child of a
+    h->sibling[b] = h->child[a];
+    if (h->child[a] != -1)
+        h->prev[h->child[a]] = b;
+    h->prev[b] = a;
+    h->child[a] = b;
+    return a;
+}
+
+void *pairing_create(int n, int max_cost)
+{
+    (void)max_cost;
+    struct pairing_heap *h = malloc(sizeof(struct pairing_heap));
+    h->root = -1;
+    h->key = malloc(n * sizeof(long long int));
+    h->child = malloc(n * sizeof(int));
+    h->sibling = malloc(n * sizeof(int));
+    h->prev = malloc(n * sizeof(int));
+    h->queued = calloc(n, sizeof(bool));
+    h->pairs = malloc(n * sizeof(int));
+    return h;
+}
+
+void pairing_push(void *q, int v, long long int d)
+{
+    struct pairing_heap *h = q;
+    h->key[v] = d;
+    if (!h->queued[v]) {
+        h->queued[v] = true;
+        h->child[v] = h->sibling[v] = h->prev[v] = -1;
+        h->root = pairing_meld(h, h->root, v);
+        return;
+    }
+    if (v == h->root)
+        return;
+
+    // cut the subtree rooted at v out of its sibling list
+    int p = h->prev[v];
+    if (h->child[p] == v)
+        h->child[p] = h->sibling[v];
+    else
+        h->sibling[p] = h->sibling[v];
+    if (h->sibling[v] != -1)
+        h->prev[h->sibling[v]] = p;
+    h->sibling[v] = h->prev[v] = -1;
+    h->root = pairing_meld(h, h->root, v);
+}
+
+int pairing_pop(void *q, long long int *d)
+{
+    struct pairing_heap *h = q;
+    int min = h->root;
+    if (min == -1)
+        return -1;
+    *d = h->key[min];
+    h->queued[min] = false;
+
+    // first pass: meld the children in pairs from left to right
+    int count = 0;
+    int c = h->child[min];
+    while (c != -1) {
+        int a = c;
+        int b = h->sibling[a];
+        c = b == -1 ? -1 : h->sibling[b];
+        h->sibling[a] = h->prev[a] = -1;
+        if (b != -1)
+            h->sibling[b] = h->prev[b] = -1;
+        h->pairs[count++] = pairing_meld(h, a, b);
+    }
+
+    // second pass: meld the pairs from right to left
+    int root = -1;
+    while (count > 0) {
+        root = pairing_meld(h, h->pairs[--count], root);
+    }
+    h->root = root;
+    return min;
+}
+
+void pairing_clear(void *q)
+{
+    struct pairing_heap *h = q;
+    if (h->root == -1)
+        return;
+
+    // walk the tree with the scratch array as a stack
+    int top = 0;
+    h->pairs[top++] = h->root;
+    while (top > 0) {
+        int v = h->pairs[--top];
+        h->queued[v] = false;
+        for (int c = h->child[v]; c != -1; c = h->sibling[c]) {
+            h->pairs[top++] = c;
+        }
+    }
+    h->root = -1;
+}
+
+void pairing_destroy(void *q)
+{
+    struct pairing_heap *h = q;
+    free(h->key);
+    free(h->child);
+    free(h->sibling);
+    free(h->prev);
+    free(h->queued);
+    free(h->pairs);
+    free(h);
+}
+
+/*
+ * lazy backend - binary heap of (dist, vertex) entries. push() always
+ * inserts, so a vertex whose distance dropped several times has stale
+ * entries that dijkstra_queue() skips when they are popped.
+ */
+void *lazy_create(int n, int max_cost)
+{
+    (void)max_cost;
+    struct lazy_heap *h = malloc(sizeof(struct lazy_heap));
+    h->heap_size = 0;
+    h->capacity = n > 16 ? n : 16;
+    h->H = malloc(h->capacity * sizeof(struct heap_entry));
+    return h;
+}
+
+void lazy_push(void *q, int v, long long int d)
+{
+    struct lazy_heap *h = q;
+    if (h->heap_size == h->capacity) {
+        h->capacity *= 2;
+        h->H = realloc(h->H, h->capacity * sizeof(struct heap_entry));
+    }
+    int i = h->heap_size++;
+    while (i > 0 && h->H[(i - 1) / 2].dist > d) {
+        h->H[i] = h->H[(i - 1) / 2];
+        i = (i - 1) / 2;
+    }
+    h->H[i].dist = d;
+    h->H[i].index = v;
+}
+
+int lazy_pop(void *q, long long int *d)
 {
-    struct vertex temp = *a;
-    *a = *b;
-    *b = temp;
+    struct lazy_heap *h = q;
+    if (h->heap_size == 0)
+        return -1;
+    struct heap_entry min = h->H[0];
+    struct heap_entry e = h->H[--h->heap_size];
+    int i = 0;
+    for (;;) {
+        int l = 2 * i + 1;
+        if (l >= h->heap_size)
+            break;
+        if (l + 1 < h->heap_size && h->H[l + 1].dist < h->H[l].dist)
+            l++;
+        if (h->H[l].dist >= e.dist)
+            break;
+        h->H[i] = h->H[l];
+        i = l;
+    }
+    h->H[i] = e;
+    *d = min.dist;
+    return min.index;
+}
+
+void lazy_clear(void *q)
+{
+    struct lazy_heap *h = q;
+    h->heap_size = 0;
 }
 
+void lazy_destroy(void *q)
+{
+    struct lazy_heap *h = q;
+    free(h->H);
+    free(h);
+}
+
+/*
+ * dial backend - Dial's algorithm. Every queued key lies in
+ * [current, current + max_cost], so max_cost + 1 buckets used
+ * circularly hold each key in its own bucket. Buckets are doubly
+ * linked lists so decrease-key is O(1) and pop() is amortized
+ * O(1) for a bounded max_cost.
+ */
+void dial_unlink(struct dial_queue *Q, int v)
+{
+    int b = Q->key[v] % Q->buckets;
+    if (Q->prev[v] != -1)
+        Q->next[Q->prev[v]] = Q->next[v];
+    else
+        Q->head[b] = Q->next[v];
+    if (Q->next[v] != -1)
+        Q->prev[Q->next[v]] = Q->prev[v];
+}
+
+void *dial_create(int n, int max_cost)
+{
+    struct dial_queue *Q = malloc(sizeof(struct dial_queue));
+    Q->size = 0;
+    Q->buckets = max_cost + 1;
+    Q->current = 0;
+    Q->head = malloc(Q->buckets * sizeof(int));
+    Q->next = malloc(n * sizeof(int));
+    Q->prev = malloc(n * sizeof(int));
+    Q->key = malloc(n * sizeof(long long int));
+    for (int i = 0; i < Q->buckets; ++i) {
+        Q->head[i] = -1;
+    }
+    for (int i = 0; i < n; ++i) {
+        Q->key[i] = -1;
+    }
+    return Q;
+}
+
+void dial_push(void *q, int v, long long int d)
+{
+    struct dial_queue *Q = q;
+    if (Q->key[v] != -1)
+        dial_unlink(Q, v);
+    else
+        Q->size++;
+
+    int b = d % Q->buckets;
+    Q->key[v] = d;
+    Q->prev[v] = -1;
+    Q->next[v] = Q->head[b];
+    if (Q->head[b] != -1)
+        Q->prev[Q->head[b]] = v;
+    Q->head[b] = v;
+}
+
+int dial_pop(void *q, long long int *d)
+{
+    struct dial_queue *Q = q;
+    if (Q->size == 0)
+        return -1;
+    while (Q->head[Q->current % Q->buckets] == -1) {
+        Q->current++;
+    }
+    int v = Q->head[Q->current % Q->buckets];
+    dial_unlink(Q, v);
+    Q->size--;
+    *d = Q->key[v];
+    Q->key[v] = -1;
+    return v;
+}
+
+void dial_clear(void *q)
+{
+    struct dial_queue *Q = q;
+    long long int d;
+    while (Q->size > 0) {
+        dial_pop(Q, &d);
+    }
+    Q->current = 0;
+}
+
+void dial_destroy(void *q)
+{
+    struct dial_queue *Q = q;
+    free(Q->head);
+    free(Q->next);
+    free(Q->prev);
+    free(Q->key);
+    free(Q);
+}
+
+/*
+ * radix backend - monotone radix heap. A key is placed in the bucket
+ * of the highest bit in which it differs from the last extracted key.
+ * When bucket 0 runs dry, the lowest non-empty bucket is redistributed
+ * around its minimum, and each entry only moves to lower buckets. Like
+ * the lazy heap, decreased keys leave stale entries behind.
+ */
+int radix_bucket(struct radix_heap *h, unsigned long long int key)
+{
+    if (key == h->last)
+        return 0;
+    return 64 - __builtin_clzll(key ^ h->last);
+}
+
+void radix_insert(struct radix_heap *h, int b, struct heap_entry e)
+{
+    if (h->count[b] == h->capacity[b]) {
+        h->capacity[b] = h->capacity[b] ? 2 * h->capacity[b] : 16;
+        h->bucket[b] = realloc(h->bucket[b], h->capacity[b] * sizeof(struct heap_entry));
+    }
+    h->bucket[b][h->count[b]++] = e;
+}
+
+void *radix_create(int n, int max_cost)
+{
+    (void)n;
+    (void)max_cost;
+    struct radix_heap *h = calloc(1, sizeof(struct radix_heap));
+    return h;
+}
+
+void radix_push(void *q, int v, long long int d)
+{
+    struct radix_heap *h = q;
+    struct heap_entry e = {d, v};
+    radix_insert(h, radix_bucket(h, d), e);
+    h->size++;
+}
+
+int radix_pop(void *q, long long int *d)
+{
+    struct radix_heap *h = q;
+    if (h->size == 0)
+        return -1;
+
+    if (h->count[0] == 0) {
+        int b = 1;
+        while (h->count[b] == 0) {
+            b++;
+        }
+        unsigned long long int min = h->bucket[b][0].dist;
+        for (int i = 1; i < h->count[b]; ++i) {
+            if ((unsigned long long int)h->bucket[b][i].dist < min)
+                min = h->bucket[b][i].dist;
+        }
+        h->last = min;
+        int count = h->count[b];
+        h->count[b] = 0;
+        for (int i = 0; i < count; ++i) {
+            struct heap_entry e = h->bucket[b][i];
+            radix_insert(h, radix_bucket(h, e.dist), e);
+        }
+    }
+
+    struct heap_entry e = h->bucket[0][--h->count[0]];
+    h->size--;
+    *d = e.dist;
+    return e.index;
+}
+
+void radix_clear(void *q)
+{
+    struct radix_heap *h = q;
+    for (int i = 0; i < RADIX_BUCKETS; ++i) {
+        h->count[i] = 0;
+    }
+    h->size = 0;
+    h->last = 0;
+}
+
+void radix_destroy(void *q)
+{
+    struct radix_heap *h = q;
+    for (int i = 0; i < RADIX_BUCKETS; ++i) {
+        free(h->bucket[i]);
+    }
+    free(h);
+}
+
+/**
+ * ch_add_edge - adds an edge to a contraction edge list
+ *
+ * @list: the edge list
+ * @head: the other end of the edge
+ * @cost: the cost of the edge
+ *
+ * Parallel edges are merged by keeping the cheaper one.
+ */
+void ch_add_edge(struct ch_edge_list *list, int head, long long int cost)
+{
+    for (int i = 0; i < list->count; ++i) {
+        if (list->head[i] == head) {
+            if (cost < list->cost[i])
+                list->cost[i] = cost;
+            return;
+        }
+    }
+    if (list->count == list->capacity) {
+        list->capacity = list->capacity ? 2 * list->capacity : 4;
+        list->head = realloc(list->head, list->capacity * sizeof(int));
+        list->cost = realloc(list->cost, list->capacity * sizeof(long long int));
+    }
+    list->head[list->count] = head;
+    list->cost[list->count] = cost;
+    list->count++;
+}
+
+/**
+ * ch_remove_edge - removes the edge to @head from a contraction edge list
+ *
+ * @list: the edge list
+ * @head: the other end of the edge
+ */
+void ch_remove_edge(struct ch_edge_list *list, int head)
+{
+    for (int i = 0; i < list->count; ++i) {
+        if (list->head[i] == head) {
+            list->count--;
+            list->head[i] = list->head[list->count];
+            list->cost[i] = list->cost[list->count];
+            return;
+        }
+    }
+}
+
+/**
+ * ch_witness_search - local dijkstra used while contracting a vertex
+ *
+ * @S:      search state used for the distances
+ * @out:    outgoing edge lists of the remaining graph
+ * @source: start vertex
+ * @skip:   the vertex being contracted, it is never entered
+ * @limit:  paths longer than @limit are not followed
+ * @settle_limit: the search stops after settling this many vertices
+ *
+ * Explores at most @settle_limit vertices. A vertex w for which
+ * S->reached[w] == S->version after the search has a path of cost
+ * S->distance[w] from @source that avoids @skip. The search may miss
+ * a witness, which only adds a superfluous shortcut.
+ */
+void ch_witness_search(struct search_state *S, struct ch_edge_list *out, int source, int skip, long long int limit, int settle_limit)
+{
+    if (++S->version == 0) {
+        memset(S->reached, 0, S->n * sizeof(unsigned int));
+        memset(S->settled, 0, S->n * sizeof(unsigned int));
+        S->version = 1;
+    }
+    unsigned int version = S->version;
+
+    S->reached[source] = version;
+    S->distance[source] = 0;
+    S->ops->push(S->Q, source, 0);
+
+    int settled_count = 0;
+    long long int d;
+    int u;
+    while ((u = S->ops->pop(S->Q, &d)) != -1) {
+        if (S->settled[u] == version || d > S->distance[u])
+            continue;
+        if (++settled_count > settle_limit)
+            break;
+        S->settled[u] = version;
+
+        for (int i = 0; i < out[u].count; ++i) {
+            int v = out[u].head[i];
+            if (v == skip || S->settled[v] == version)
+                continue;
+            long long int curr_dist = d + out[u].cost[i];
+            if (curr_dist > limit)
+                continue;
+            if (S->reached[v] != version || curr_dist < S->distance[v]) {
+                S->reached[v] = version;
+                S->distance[v] = curr_dist;
+                S->ops->push(S->Q, v, curr_dist);
+            }
+        }
+    }
+    S->ops->clear(S->Q);
+}
+
+/**
+ * ch_contract - contracts a vertex, or only counts its shortcuts
+ *
+ * @S:        search state for the witness searches
+ * @in:       incoming edge lists of the remaining graph
+ * @out:      outgoing edge lists of the remaining graph
+ * @v:        the vertex to contract
+ * @simulate: if true, the shortcuts are counted but not added, with
+ *            a cheaper witness search that may overcount them
+ *
+ * For every pair of neighbours u -> v -> w a shortcut u -> w is needed
+ * unless a witness search from u finds a path to w avoiding v that is
+ * not longer than going through v. When @v is really contracted, it is
+ * also removed from the lists of its neighbours, so the lists of @v are
+ * left with exactly its upward edges.
+ *
+ * Return: the number of shortcuts needed
+ */
+int ch_contract(struct search_state *S, struct ch_edge_list *in, struct ch_edge_list *out, int v, bool simulate)
+{
+    int shortcuts = 0;
+
+    // the largest cost of leaving v, bounds the witness searches
+    long long int max_out = 0;
+    for (int j = 0; j < out[v].count; ++j) {
+        if (out[v].cost[j] > max_out)
+            max_out = out[v].cost[j];
+    }
+
+    for (int i = 0; i < in[v].count; ++i) {
+        int u = in[v].head[i];
+        long long int to_v = in[v].cost[i];
+        ch_witness_search(S, out, u, v, to_v + max_out,
+                          simulate ? CH_SIMULATE_LIMIT : CH_WITNESS_LIMIT);
+
+        for (int j = 0; j < out[v].count; ++j) {
+            int w = out[v].head[j];
+            if (w == u)
+                continue;
+            long long int via_v = to_v + out[v].cost[j];
+            if (S->reached[w] == S->version && S->distance[w] <= via_v)
+                continue;
+            shortcuts++;
+            if (!simulate) {
+                ch_add_edge(&out[u], w, via_v);
+                ch_add_edge(&in[w], u, via_v);
+            }
+        }
+    }
+
+    if (!simulate) {
+        for (int i = 0; i < in[v].count; ++i) {
+            ch_remove_edge(&out[in[v].head[i]], v);
+        }
+        for (int j = 0; j < out[v].count; ++j) {
+            ch_remove_edge(&in[out[v].head[j]], v);
+        }
+    }
+    return shortcuts;
+}
+
+/**
+ * ch_priority - the contraction priority of a vertex
+ *
+ * The edge difference (shortcuts added minus edges removed) plus the
+ * number of already contracted neighbours, which spreads the
+ * contraction evenly over the graph. Smaller is contracted earlier.
+ */
+long long int ch_priority(struct search_state *S, struct ch_edge_list *in, struct ch_edge_list *out, int *deleted_neighbors, int v)
+{
+    int shortcuts = ch_contract(S, in, out, v, true);
+    return shortcuts - in[v].count - out[v].count + deleted_neighbors[v];
+}
+
+/**
+ * ch_build - builds a contraction hierarchy of the graph
+ *
+ * @adj:      adjacency list representing the graph.
+ * @cost:     cost matrix representing the weights of edges in the graph.
+ * @edges:    array representing the number of edges for each vertex.
+ * @n:        number of vertices in the graph.
+ * @max_cost: the largest edge cost.
+ *
+ * Vertices are contracted one by one in the order of ch_priority(),
+ * kept in a lazy heap. After a contraction the priorities of the
+ * neighbours are recomputed and queued again, which leaves their old
+ * entries stale. A popped vertex whose priority still went up since it
+ * was queued is pushed back instead of contracted. Once a vertex is
+ * contracted its remaining edges all lead to higher ranks, so its
+ * outgoing list becomes its forward upward graph and its incoming list
+ * its backward upward graph.
+ *
+ * Return: pointer to the hierarchy
+ */
+struct hierarchy *ch_build(int **adj, int **cost, int *edges, int n, int max_cost)
+{
+    struct ch_edge_list *in = calloc(n, sizeof(struct ch_edge_list));
+    struct ch_edge_list *out = calloc(n, sizeof(struct ch_edge_list));
+    for (int u = 0; u < n; ++u) {
+        for (int i = 0; i < edges[u]; ++i) {
+            int v = adj[u][i];
+            if (u == v)
+                continue;
+            ch_add_edge(&out[u], v, cost[u][i]);
+            ch_add_edge(&in[v], u, cost[u][i]);
+        }
+    }
+
+    int *deleted_neighbors = calloc(n, sizeof(int));
+    struct search_state *S = init_search_state(find_queue_ops("binary"), n, max_cost);
+
+    struct hierarchy *H = malloc(sizeof(struct hierarchy));
+    H->n = n;
+    H->rank = malloc(n * sizeof(int));
+    for (int v = 0; v < n; ++v) {
+        H->rank[v] = -1;
+    }
+
+    // initial node order, priority[v] is the key of the live entry of v
+    long long int *priority = malloc(n * sizeof(long long int));
+    void *order = lazy_create(n, 0);
+    for (int v = 0; v < n; ++v) {
+        priority[v] = ch_priority(S, in, out, deleted_neighbors, v);
+        lazy_push(order, v, priority[v]);
+    }
+
+    int next_rank = 0;
+    long long int key;
+    int v;
+    while ((v = lazy_pop(order, &key)) != -1) {
+        if (H->rank[v] != -1 || key != priority[v])
+            continue;
+        priority[v] = ch_priority(S, in, out, deleted_neighbors, v);
+        if (priority[v] > key) {
+            lazy_push(order, v, priority[v]);
+            continue;
+        }
+
+        ch_contract(S, in, out, v, false);
+        H->rank[v] = next_rank++;
+
+        // the neighbours lost an edge and may have gained shortcuts
+        for (int k = 0; k < 2; ++k) {
+            struct ch_edge_list *list = k == 0 ? &in[v] : &out[v];
+            for (int i = 0; i < list->count; ++i) {
+                int x = list->head[i];
+                deleted_neighbors[x]++;
+                long long int updated = ch_priority(S, in, out, deleted_neighbors, x);
+                if (updated != priority[x]) {
+                    priority[x] = updated;
+                    lazy_push(order, x, updated);
+                }
+            }
+        }
+    }
+    lazy_destroy(order);
+    free(priority);
+    free_search_state(S);
+
+    // pack the upward edge lists into CSR arrays
+    H->fwd_first = malloc((n + 1) * sizeof(int));
+    H->bwd_first = malloc((n + 1) * sizeof(int));
+    H->fwd_first[0] = H->bwd_first[0] = 0;
+    for (int u = 0; u < n; ++u) {
+        H->fwd_first[u + 1] = H->fwd_first[u] + out[u].count;
+        H->bwd_first[u + 1] = H->bwd_first[u] + in[u].count;
+    }
+    H->fwd_head = malloc(H->fwd_first[n] * sizeof(int));
+    H->fwd_cost = malloc(H->fwd_first[n] * sizeof(long long int));
+    H->bwd_head = malloc(H->bwd_first[n] * sizeof(int));
+    H->bwd_cost = malloc(H->bwd_first[n] * sizeof(long long int));
+    for (int u = 0; u < n; ++u) {
+        if (out[u].count > 0) {
+            memcpy(H->fwd_head + H->fwd_first[u], out[u].head, out[u].count * sizeof(int));
+            memcpy(H->fwd_cost + H->fwd_first[u], out[u].cost, out[u].count * sizeof(long long int));
+        }
+        if (in[u].count > 0) {
+            memcpy(H->bwd_head + H->bwd_first[u], in[u].head, in[u].count * sizeof(int));
+            memcpy(H->bwd_cost + H->bwd_first[u], in[u].cost, in[u].count * sizeof(long long int));
+        }
+        free(in[u].head);
+        free(in[u].cost);
+        free(out[u].head);
+        free(out[u].cost);
+    }
+    free(in);
+    free(out);
+    free(deleted_neighbors);
+    return H;
+}
+
+/**
+ * ch_step - settles the next vertex of one direction of ch_query()
+ *
+ * @H:       the hierarchy
+ * @S:       search state of this direction
+ * @other:   search state of the opposite direction
+ * @forward: true for the search from s, false for the search from t
+ * @best:    the shortest s-t distance found so far, -1 if none
+ * @top:     set to the key of the settled vertex, -1 if the queue ran dry
+ *
+ * Uses stall-on-demand: if a higher ranked vertex x already reached by
+ * this direction offers a shorter path to the settled vertex u through
+ * an edge between x and u, the key of u is not its distance, so u is
+ * not relaxed.
+ */
+void ch_step(struct hierarchy *H, struct search_state *S, struct search_state *other, bool forward, long long int *best, long long int *top)
+{
+    int *first = forward ? H->fwd_first : H->bwd_first;
+    int *head = forward ? H->fwd_head : H->bwd_head;
+    long long int *cost = forward ? H->fwd_cost : H->bwd_cost;
+    int *down_first = forward ? H->bwd_first : H->fwd_first;
+    int *down_head = forward ? H->bwd_head : H->fwd_head;
+    long long int *down_cost = forward ? H->bwd_cost : H->fwd_cost;
+
+    unsigned int version = S->version;
+    long long int d;
+    int u;
+    do {
+        u = S->ops->pop(S->Q, &d);
+        if (u == -1) {
+            *top = -1;
+            return;
+        }
+    } while (S->settled[u] == version || d > S->distance[u]);
+    S->settled[u] = version;
+    S->settled_count++;
+    *top = d;
+
+    // a vertex reached from both sides closes an s-t path
+    if (other->reached[u] == other->version) {
+        long long int through_u = d + other->distance[u];
+        if (*best == -1 || through_u < *best)
+            *best = through_u;
+    }
+
+    for (int i = down_first[u]; i < down_first[u + 1]; ++i) {
+        int x = down_head[i];
+        if (S->reached[x] == version && S->distance[x] + down_cost[i] < d)
+            return;
+    }
+
+    for (int i = first[u]; i < first[u + 1]; ++i) {
+        int v = head[i];
+        long long int curr_dist = d + cost[i];
+        if (S->reached[v] != version || curr_dist < S->distance[v]) {
+            S->reached[v] = version;
+            S->distance[v] = curr_dist;
+            S->ops->push(S->Q, v, curr_dist);
+        }
+    }
+}
+
+/**
+ * ch_query - shortest path length with a contraction hierarchy
+ *
+ * @H: the hierarchy
+ * @F: search state of the forward search from @s
+ * @B: search state of the backward search from @t
+ * @s: source vertex index
+ * @t: target vertex index
+ *
+ * Runs dijkstra from @s in the forward upward graph and from @t in the
+ * backward upward graph, alternating between them. The shortest path
+ * climbs to its highest ranked vertex and then descends, so it is found
+ * where the two searches meet. A direction stops once its smallest key
+ * is not below the best path found so far.
+ *
+ * Return: the length of the shortest path from @s to @t, -1 if none
+ */
+long long int ch_query(struct hierarchy *H, struct search_state *F, struct search_state *B, int s, int t)
+{
+    struct search_state *sides[2] = {F, B};
+    int vertices[2] = {s, t};
+    for (int k = 0; k < 2; ++k) {
+        struct search_state *S = sides[k];
+        if (++S->version == 0) {
+            memset(S->reached, 0, S->n * sizeof(unsigned int));
+            memset(S->settled, 0, S->n * sizeof(unsigned int));
+            S->version = 1;
+        }
+        S->reached[vertices[k]] = S->version;
+        S->distance[vertices[k]] = 0;
+        S->ops->push(S->Q, vertices[k], 0);
+    }
+
+    long long int best = -1;
+    bool fwd_done = false;
+    bool bwd_done = false;
+    long long int top;
+    while (!fwd_done || !bwd_done) {
+        if (!fwd_done) {
+            ch_step(H, F, B, true, &best, &top);
+            fwd_done = top == -1 || (best != -1 && top >= best);
+        }
+        if (!bwd_done) {
+            ch_step(H, B, F, false, &best, &top);
+            bwd_done = top == -1 || (best != -1 && top >= best);
+        }
+    }
+    F->ops->clear(F->Q);
+    B->ops->clear(B->Q);
+
+    return best;
+}
+
+/**
+ * ch_answer_queries - answers every "s t" line of the input with @H
+ *
+ * @H:          the hierarchy
+ * @adj:        adjacency list of the graph, or NULL to skip the check
+ * @cost:       cost matrix representing the weights of edges in the graph.
+ * @edges:      array representing the number of edges for each vertex.
+ * @print_time: print the total query time to stderr
+ *
+ * If the graph is given, every answer is checked against dijkstra().
+ */
+void ch_answer_queries(struct hierarchy *H, int **adj, int **cost, int *edges, bool print_time)
+{
+    struct search_state *F = init_search_state(find_queue_ops("binary"), H->n, 0);
+    struct search_state *B = init_search_state(find_queue_ops("binary"), H->n, 0);
+
+    int s, t;
+    int queries = 0;
+    clock_t elapsed = 0;
+    while (scanf("%d %d", &s, &t) == 2) {
+        s--; t--;
+        clock_t start = clock();
+        long long int result = ch_query(H, F, B, s, t);
+        elapsed += clock() - start;
+        queries++;
+        printf("%lld\n", result);
+
+        if (adj != NULL) {
+            long long int expected = dijkstra(adj, cost, edges, s, t, H->n);
+            if (expected != result) {
+                fprintf(stderr, "mismatch for %d %d: ch %lld, dijkstra %lld\n",
+                        s + 1, t + 1, result, expected);
+            }
+        }
+    }
+
+    if (print_time) {
+        fprintf(stderr, "ch: %d queries, %.3f us and %.1f settled vertices per query\n", queries,
+                queries ? 1e6 * elapsed / CLOCKS_PER_SEC / queries : 0.0,
+                queries ? (double)(F->settled_count + B->settled_count) / queries : 0.0);
+    }
+    free_search_state(F);
+    free_search_state(B);
+}
+
+/**
+ * ch_save - writes a hierarchy to a binary file
+ *
+ * @H:    the hierarchy
+ * @path: the file to write
+ *
+ * The file holds CH_FILE_MAGIC, n, the number of forward and backward
+ * edges, then the rank, forward and backward CSR arrays in this order.
+ *
+ * Return: 0 on success, -1 if the file cannot be written
+ */
+int ch_save(struct hierarchy *H, const char *path)
+{
+    FILE *f = fopen(path, "wb");
+    if (f == NULL)
+        return -1;
+
+    int n = H->n;
+    int header[4] = {CH_FILE_MAGIC, n, H->fwd_first[n], H->bwd_first[n]};
+    bool ok = fwrite(header, sizeof(int), 4, f) == 4
+        && fwrite(H->rank, sizeof(int), n, f) == (size_t)n
+        && fwrite(H->fwd_first, sizeof(int), n + 1, f) == (size_t)n + 1
+        && fwrite(H->fwd_head, sizeof(int), header[2], f) == (size_t)header[2]
+        && fwrite(H->fwd_cost, sizeof(long long int), header[2], f) == (size_t)header[2]
+        && fwrite(H->bwd_first, sizeof(int), n + 1, f) == (size_t)n + 1
+        && fwrite(H->bwd_head, sizeof(int), header[3], f) == (size_t)header[3]
+        && fwrite(H->bwd_cost, sizeof(long long int), header[3], f) == (size_t)header[3];
+
+    if (fclose(f) != 0)
+        ok = false;
+    return ok ? 0 : -1;
+}
+
+/**
+ * ch_load - reads a hierarchy written by ch_save()
+ *
+ * @path: the file to read
+ *
+ * Return: pointer to the hierarchy, NULL if the file cannot be read
+ */
+struct hierarchy *ch_load(const char *path)
+{
+    FILE *f = fopen(path, "rb");
+    if (f == NULL) {
+        fprintf(stderr, "cannot open hierarchy: %s\n", path);
+        return NULL;
+    }
+
+    int header[4];
+    if (fread(header, sizeof(int), 4, f) != 4 || header[0] != CH_FILE_MAGIC) {
+        fprintf(stderr, "not a hierarchy file: %s\n", path);
+        fclose(f);
+        return NULL;
+    }
+
+    int n = header[1];
+    struct hierarchy *H = malloc(sizeof(struct hierarchy));
+    H->n = n;
+    H->rank = malloc(n * sizeof(int));
+    H->fwd_first = malloc((n + 1) * sizeof(int));
+    H->fwd_head = malloc(header[2] * sizeof(int));
+    H->fwd_cost = malloc(header[2] * sizeof(long long int));
+    H->bwd_first = malloc((n + 1) * sizeof(int));
+    H->bwd_head = malloc(header[3] * sizeof(int));
+    H->bwd_cost = malloc(header[3] * sizeof(long long int));
+
+    bool ok = fread(H->rank, sizeof(int), n, f) == (size_t)n
+        && fread(H->fwd_first, sizeof(int), n + 1, f) == (size_t)n + 1
+        && fread(H->fwd_head, sizeof(int), header[2], f) == (size_t)header[2]
+        && fread(H->fwd_cost, sizeof(long long int), header[2], f) == (size_t)header[2]
+        && fread(H->bwd_first, sizeof(int), n + 1, f) == (size_t)n + 1
+        && fread(H->bwd_head, sizeof(int), header[3], f) == (size_t)header[3]
+        && fread(H->bwd_cost, sizeof(long long int), header[3], f) == (size_t)header[3];
+    fclose(f);
+
+    if (!ok) {
+        fprintf(stderr, "truncated hierarchy file: %s\n", path);
+        free_hierarchy(H);
+        return NULL;
+    }
+    return H;
+}
+
+void free_hierarchy(struct hierarchy *H)
+{
+    free(H->rank);
+    free(H->fwd_first);
+    free(H->fwd_head);
+    free(H->fwd_cost);
+    free(H->bwd_first);
+    free(H->bwd_head);
+    free(H->bwd_cost);
+    free(H);
+}
+
+/**
+ * reverse_adj_list - reverse the directions of the adjacency list
+ *
+ * @adj:                 adjacency list representing the graph
+ * @edges:               array representing the number of edges for each vertex
+ * @incoming_edge_count: filled with the incoming edge number per vertex
+ * @n:                   number of vertices
+ *
+ * The edges are counted first, so every reversed list is allocated once.
+ *
+ * Return: 2D reversed adjacency list
+ */
+int **reverse_adj_list(int **adj, int *edges, int *incoming_edge_count, int n)
+{
+    for (int u = 0; u < n; ++u) {
+        for (int i = 0; i < edges[u]; ++i) {
+            incoming_edge_count[adj[u][i]]++;
+        }
+    }
+
+    int **reversed_adj_list = malloc(n * sizeof(int *));
+    int *fill = calloc(n, sizeof(int));
+    for (int v = 0; v < n; ++v) {
+        reversed_adj_list[v] = malloc(incoming_edge_count[v] * sizeof(int));
+    }
+    for (int u = 0; u < n; ++u) {
+        for (int i = 0; i < edges[u]; ++i) {
+            int v = adj[u][i];
+            reversed_adj_list[v][fill[v]++] = u;
+        }
+    }
+    free(fill);
+    return reversed_adj_list;
+}
+
+/**
+ * reverse_cost_list - the costs of the reversed adjacency list
+ *
+ * @adj:   adjacency list representing the graph
+ * @cost:  cost matrix representing the weights of edges in the graph
+ * @edges: array representing the number of edges for each vertex
+ * @n:     number of vertices
+ *
+ * The edges are visited in the same order as in reverse_adj_list(),
+ * so the costs line up with the reversed adjacency list.
+ *
+ * Return: 2D reversed cost list
+ */
+int **reverse_cost_list(int **adj, int **cost, int *edges, int n)
+{
+    int *incoming_edge_count = calloc(n, sizeof(int));
+    for (int u = 0; u < n; ++u) {
+        for (int i = 0; i < edges[u]; ++i) {
+            incoming_edge_count[adj[u][i]]++;
+        }
+    }
+
+    int **reversed_cost_list = malloc(n * sizeof(int *));
+    for (int v = 0; v < n; ++v) {
+        reversed_cost_list[v] = malloc(incoming_edge_count[v] * sizeof(int));
+        incoming_edge_count[v] = 0;
+    }
+    for (int u = 0; u < n; ++u) {
+        for (int i = 0; i < edges[u]; ++i) {
+            int v = adj[u][i];
+            reversed_cost_list[v][incoming_edge_count[v]++] = cost[u][i];
+        }
+    }
+    free(incoming_edge_count);
+    return reversed_cost_list;
+}
+
+/**
+ * start_query - starts a new query on a search state
+ *
+ * @S: the search state
+ * @s: the start vertex, queued with key @key
+ * @key: the key of @s
+ */
+void start_query(struct search_state *S, int s, long long int key)
+{
+    if (++S->version == 0) {
+        memset(S->reached, 0, S->n * sizeof(unsigned int));
+        memset(S->settled, 0, S->n * sizeof(unsigned int));
+        S->version = 1;
+    }
+    S->reached[s] = S->version;
+    S->distance[s] = 0;
+    S->ops->push(S->Q, s, key);
+}
+
+/**
+ * next_settled - pops the next vertex that is not stale or settled
+ *
+ * @S:   the search state
+ * @key: set to the key of the vertex
+ *
+ * Return: the vertex, -1 if the queue is empty
+ */
+int next_settled(struct search_state *S, long long int *key)
+{
+    int u;
+    do {
+        u = S->ops->pop(S->Q, key);
+    } while (u != -1 && (S->settled[u] == S->version || *key > S->distance[u]));
+    return u;
+}
+
+/**
+ * bidirectional_search - shortest path length with bidirectional dijkstra
+ *
+ * @F:      search state of the forward search from @s
+ * @B:      search state of the backward search from @t
+ * @adj:    adjacency list representing the graph.
+ * @cost:   cost matrix representing the weights of edges in the graph.
+ * @edges:  array representing the number of edges for each vertex.
+ * @radj:   the reversed adjacency list.
+ * @rcost:  the costs of the reversed adjacency list.
+ * @redges: the number of incoming edges of each vertex.
+ * @s:      source vertex index.
+ * @t:      target vertex index.
+ *
+ * Runs dijkstra from @s on the graph and from @t on the reversed graph,
+ * always advancing the side with the smaller minimum key. Every edge
+ * relaxed towards a vertex reached by the other side gives a candidate
+ * path, and the best one is kept. Once the two minimum keys add up to
+ * at least the best path, no unsettled vertex can improve it and the
+ * search stops. If a side runs dry, every path from @s (or to @t) is
+ * already known.
+ *
+ * Return: the length of the shortest path from @s to @t, -1 if none
+ */
+long long int bidirectional_search(struct search_state *F, struct search_state *B, int **adj, int **cost, int *edges, int **radj, int **rcost, int *redges, int s, int t)
+{
+    start_query(F, s, 0);
+    start_query(B, t, 0);
+
+    struct search_state *sides[2] = {F, B};
+    int **side_adj[2] = {adj, radj};
+    int **side_cost[2] = {cost, rcost};
+    int *side_edges[2] = {edges, redges};
+
+    long long int best = s == t ? 0 : -1;
+    long long int top[2];
+    int next[2];
+    next[0] = next_settled(F, &top[0]);
+    next[1] = next_settled(B, &top[1]);
+
+    while (next[0] != -1 && next[1] != -1) {
+        if (best != -1 && top[0] + top[1] >= best)
+            break;
+
+        int k = top[0] <= top[1] ? 0 : 1;
+        struct search_state *S = sides[k];
+        struct search_state *other = sides[1 - k];
+        int u = next[k];
+        long long int d = top[k];
+        S->settled[u] = S->version;
+        S->settled_count++;
+
+        for (int i = 0; i < side_edges[k][u]; ++i) {
+            int v = side_adj[k][u][i];
+            long long int curr_dist = d + side_cost[k][u][i];
+            if (S->settled[v] == S->version)
+                continue;
+            if (S->reached[v] != S->version || curr_dist < S->distance[v]) {
+                S->reached[v] = S->version;
+                S->distance[v] = curr_dist;
+                S->ops->push(S->Q, v, curr_dist);
+            }
+            // the edge closes a path if the other side reached v
+            if (other->reached[v] == other->version) {
+                long long int through_v = curr_dist + other->distance[v];
+                if (best == -1 || through_v < best)
+                    best = through_v;
+            }
+        }
+        next[k] = next_settled(S, &top[k]);
+    }
+    F->ops->clear(F->Q);
+    B->ops->clear(B->Q);
+
+    return best;
+}
+
+/**
+ * alt_preprocess - picks landmarks and computes their distance tables
+ *
+ * @S:      search state used for the full dijkstra searches
+ * @adj:    adjacency list representing the graph.
+ * @cost:   cost matrix representing the weights of edges in the graph.
+ * @edges:  array representing the number of edges for each vertex.
+ * @radj:   the reversed adjacency list.
+ * @rcost:  the costs of the reversed adjacency list.
+ * @redges: the number of incoming edges of each vertex.
+ * @n:      number of vertices in the graph.
+ * @count:  number of landmarks, at most @n are used
+ *
+ * Farthest selection: the first landmark is vertex 0, every next one is
+ * the vertex farthest from the landmarks chosen so far (an unreachable
+ * vertex counts as the farthest). Each landmark needs one search on the
+ * graph and one on the reversed graph.
+ *
+ * Return: pointer to the landmark tables
+ */
+struct landmarks *alt_preprocess(struct search_state *S, int **adj, int **cost, int *edges, int **radj, int **rcost, int *redges, int n, int count)
+{
+    if (count > n)
+        count = n;
+    struct landmarks *L = malloc(sizeof(struct landmarks));
+    L->count = count;
+    L->n = n;
+    L->vertex = malloc(count * sizeof(int));
+    L->from = malloc((size_t)count * n * sizeof(long long int));
+    L->to = malloc((size_t)count * n * sizeof(long long int));
+    L->potential = malloc(n * sizeof(long long int));
+
+    // closest[v] is the distance from v to its closest landmark, -1 if none
+    long long int *closest = malloc(n * sizeof(long long int));
+    for (int v = 0; v < n; ++v) {
+        closest[v] = -1;
+    }
+
+    int landmark = 0;
+    for (int k = 0; k < count; ++k) {
+        L->vertex[k] = landmark;
+        long long int *from = L->from + (size_t)k * n;
+        long long int *to = L->to + (size_t)k * n;
+
+        dijkstra_search(S, adj, cost, edges, landmark, -1);
+        for (int v = 0; v < n; ++v) {
+            from[v] = S->settled[v] == S->version ? S->distance[v] : -1;
+        }
+        dijkstra_search(S, radj, rcost, redges, landmark, -1);
+        for (int v = 0; v < n; ++v) {
+            to[v] = S->settled[v] == S->version ? S->distance[v] : -1;
+        }
+
+        // the next landmark is the vertex farthest from all landmarks
+        long long int farthest = -1;
+        for (int v = 0; v < n; ++v) {
+            if (from[v] != -1 && (closest[v] == -1 || from[v] < closest[v]))
+                closest[v] = from[v];
+            bool is_landmark = false;
+            for (int j = 0; j <= k; ++j) {
+                if (L->vertex[j] == v)
+                    is_landmark = true;
+            }
+            if (is_landmark)
+                continue;
+            long long int key = closest[v] == -1 ? LLONG_MAX : closest[v];
+            if (key > farthest) {
+                farthest = key;
+                landmark = v;
+            }
+        }
+    }
+    free(closest);
+    return L;
+}
+
+/**
+ * alt_bound - lower bound of the distance from @v to @t
+ *
+ * By the triangle inequality, d(v, t) >= d(l, t) - d(l, v) and
+ * d(v, t) >= d(v, l) - d(t, l) for every landmark l. Terms with an
+ * unreachable pair carry no information and are skipped.
+ */
+long long int alt_bound(struct landmarks *L, int v, int t)
+{
+    long long int bound = 0;
+    for (int k = 0; k < L->count; ++k) {
+        long long int *from = L->from + (size_t)k * L->n;
+        long long int *to = L->to + (size_t)k * L->n;
+        if (from[t] != -1 && from[v] != -1 && from[t] - from[v] > bound)
+            bound = from[t] - from[v];
+        if (to[v] != -1 && to[t] != -1 && to[v] - to[t] > bound)
+            bound = to[v] - to[t];
+    }
+    return bound;
+}
+
+/**
+ * alt_search - shortest path length with A* and landmark lower bounds
+ *
+ * @S:     the search state
+ * @L:     the landmark tables
+ * @adj:   adjacency list representing the graph.
+ * @cost:  cost matrix representing the weights of edges in the graph.
+ * @edges: array representing the number of edges for each vertex.
+ * @s:     source vertex index.
+ * @t:     target vertex index.
+ *
+ * Vertices are keyed by distance plus alt_bound(), so the search is
+ * pulled towards @t. The bounds are feasible potentials, hence a vertex
+ * is settled with its final distance and the search stops at @t. The
+ * bound of a vertex is computed once per query, when it is reached.
+ *
+ * Return: the length of the shortest path from @s to @t, -1 if none
+ */
+long long int alt_search(struct search_state *S, struct landmarks *L, int **adj, int **cost, int *edges, int s, int t)
+{
+    L->potential[s] = alt_bound(L, s, t);
+    start_query(S, s, L->potential[s]);
+    unsigned int version = S->version;
+
+    long long int key;
+    int u;
+    while ((u = S->ops->pop(S->Q, &key)) != -1) {
+        if (S->settled[u] == version || key > S->distance[u] + L->potential[u])
+            continue;
+        S->settled[u] = version;
+        S->settled_count++;
+        if (u == t)
+            break;
+
+        long long int d = S->distance[u];
+        for (int i = 0; i < edges[u]; ++i) {
+            int v = adj[u][i];
+            long long int curr_dist = d + cost[u][i];
+            if (S->settled[v] == version)
+                continue;
+            if (S->reached[v] != version) {
+                L->potential[v] = alt_bound(L, v, t);
+            } else if (curr_dist >= S->distance[v]) {
+                continue;
+            }
+            S->reached[v] = version;
+            S->distance[v] = curr_dist;
+            S->ops->push(S->Q, v, curr_dist + L->potential[v]);
+        }
+    }
+    S->ops->clear(S->Q);
+
+    return S->settled[t] == version ? S->distance[t] : -1;
+}
+
+void free_landmarks(struct landmarks *L)
+{
+    free(L->vertex);
+    free(L->from);
+    free(L->to);
+    free(L->potential);
+    free(L);
+}
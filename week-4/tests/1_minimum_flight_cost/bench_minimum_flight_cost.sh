@@ -0,0 +1,87 @@
+#!/bin/bash
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 ../../../week-4/minimum_flight_cost.c -Wall -lm -o bench.out &&
+
+# priority queue backends to compare, "" runs the reference dijkstra()
+backends=("" "--queue=binary" "--queue=4ary" "--queue=pairing" "--queue=lazy" "--queue=dial" "--queue=radix")
+
+# road graph: side x side grid, roads in both directions with costs 1..10
+generate_road_graph() {
+    awk -v side="$1" -v seed="$2" 'BEGIN {
+        srand(seed)
+        n = side * side
+        m = 4 * side * (side - 1)
+        print n, m
+        for (r = 0; r < side; ++r) {
+            for (c = 0; c < side; ++c) {
+                v = r * side + c + 1
+                if (c + 1 < side) {
+                    print v, v + 1, int(1 + 10 * rand())
+                    print v + 1, v, int(1 + 10 * rand())
+                }
+                if (r + 1 < side) {
+                    print v, v + side, int(1 + 10 * rand())
+                    print v + side, v, int(1 + 10 * rand())
+                }
+            }
+        }
+        print 1, n
+    }'
+}
+
+# flight graph: n airports, m flights with costs 1..100, the departure
+# airport is skewed towards low indices so a few hubs have most flights
+generate_flight_graph() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            a = int(n * rand() * rand()) + 1
+            b = int(n * rand()) + 1
+            print a, b, int(1 + 100 * rand())
+        }
+        print 1, n
+    }'
+}
+
+# count random "s t" queries over n vertices
+generate_queries() {
+    awk -v n="$1" -v count="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        for (i = 0; i < count; ++i) {
+            print int(n * rand()) + 1, int(n * rand()) + 1
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_road_graph 700 1 > "$tmp_dir/road"
+generate_flight_graph 500000 4000000 2 > "$tmp_dir/flight"
+
+for graph in road flight
+do
+    echo "$graph graph: $(head -n 1 "$tmp_dir/$graph")"
+    for backend in "${backends[@]}"
+    do
+        # the program prints the search time (without parsing) to stderr
+        ./bench.out $backend --time < "$tmp_dir/$graph" 2>&1 >/dev/null | sed 's/^/    /'
+    done
+done
+
+# point-to-point searches and contraction hierarchies against the
+# reusable dijkstra search
+generate_road_graph 150 3 | sed '$d' > "$tmp_dir/grid"
+generate_queries 22500 1000 4 > "$tmp_dir/queries"
+echo "1000 queries on a 150 x 150 road grid"
+for mode in --multi --bidir --alt
+do
+    cat "$tmp_dir/grid" "$tmp_dir/queries" | ./bench.out $mode --time 2>&1 >/dev/null | sed 's/^/    /'
+done
+start=$(date +%s%N)
+cat "$tmp_dir/grid" | ./bench.out --ch-build="$tmp_dir/grid.ch"
+end=$(date +%s%N)
+echo "    ch preprocessing: $(( (end - start) / 1000000 )) ms"
+./bench.out --ch="$tmp_dir/grid.ch" --time < "$tmp_dir/queries" 2>&1 >/dev/null | sed 's/^/    /'
+
+rm -rf "$tmp_dir" bench.out
@@ -0,0 +1,48 @@
+#!/bin/bash
+
+# usage: ./bench_detecting_anomalies.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 -pthread ../../../week-4/detecting_anomalies.c -Wall -lm -o bench.out &&
+
+# arbitrage graph: n currencies, m rates. the cost of u -> v is
+# base + p[u] - p[v] for random potentials p, so many costs are negative
+# but every cycle costs sum(base) >= 0. with cycle=1 one extra edge
+# closes a negative cycle through currency 2.
+generate_arbitrage_graph() {
+    awk -v n="$1" -v m="$2" -v seed="$3" -v cycle="$4" 'BEGIN {
+        srand(seed)
+        for (i = 1; i <= n; ++i) {
+            p[i] = int(1000 * rand())
+        }
+        print n, m + cycle
+        for (i = 0; i < m; ++i) {
+            a = int(n * rand()) + 1
+            b = int(n * rand()) + 1
+            print a, b, int(100 * rand()) + p[a] - p[b]
+        }
+        if (cycle) {
+            print 2, 2, -1
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_arbitrage_graph 200000 2000000 1 0 > "$tmp_dir/plain"
+# a negative cycle keeps the passes going until pass n, so it gets a
+# smaller graph
+generate_arbitrage_graph 5000 50000 1 1 > "$tmp_dir/cycle"
+
+for graph in plain cycle
+do
+    echo "$graph graph: $(head -n 1 "$tmp_dir/$graph")"
+    echo "    queue: $(./bench.out --time < "$tmp_dir/$graph" 2>&1 >/dev/null)"
+    echo "    passes: $(./bench.out --passes --time < "$tmp_dir/$graph" 2>&1 >/dev/null)"
+    for (( t = 1; t <= max_threads; ++t ))
+    do
+        echo "    $t threads: $(./bench.out --threads=$t --time < "$tmp_dir/$graph" 2>&1 >/dev/null)"
+    done
+done
+
+rm -rf "$tmp_dir" bench.out
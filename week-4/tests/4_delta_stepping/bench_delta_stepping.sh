@@ -0,0 +1,38 @@
+#!/bin/bash
+
+# usage: ./bench_delta_stepping.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations
+gcc -pipe -O2 -std=c11 -pthread ../../../week-4/delta_stepping.c -Wall -lm -o bench.out &&
+
+# random graph: n vertices, m edges with costs 1..max_cost, source 1
+generate_graph() {
+    awk -v n="$1" -v m="$2" -v max_cost="$3" -v seed="$4" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            print int(n * rand()) + 1, int(n * rand()) + 1, int(1 + max_cost * rand())
+        }
+        print 1, n
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+generate_graph 1000000 10000000 100 1 > "$tmp_dir/graph"
+echo "graph: $(head -n 1 "$tmp_dir/graph")"
+
+# thread scaling with the default delta (max cost / average out-degree)
+for (( t = 1; t <= max_threads; ++t ))
+do
+    ./bench.out --threads=$t --time < "$tmp_dir/graph" 2>&1 >/dev/null | sed 's/^/    /'
+done
+
+# bucket width with all threads: small deltas mean many phases, large
+# deltas mean vertices relaxed several times per bucket
+for delta in 1 10 100 1000
+do
+    ./bench.out --threads=$max_threads --delta=$delta --time < "$tmp_dir/graph" 2>&1 >/dev/null | sed 's/^/    /'
+done
+
+rm -rf "$tmp_dir" bench.out
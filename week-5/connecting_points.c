@@ -1,103 +1,731 @@
+#define _POSIX_C_SOURCE 200809L
+
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
 #include <math.h>
+#include <limits.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#if defined(__AVX2__) || defined(__SSE4_1__)
+#include <immintrin.h>
+#endif
+#include "union_find.h"
+
+// k-d tree leaves hold at most this many points
+#define KD_LEAF_SIZE 8
+
+// threads used by emst() and edge_list_mst(), set with --threads
+static int thread_count = 1;
 
 struct point {
     int x;
     int y;
 };
 
+// edge keyed by its exact squared length
 struct edge {
+    uint64_t d2;
     int src;
     int dest;
-    double weight;
 };
 
-// calculate distance between two points
-double distance(struct point p1, struct point p2) {
-    return sqrt(pow(p1.x - p2.x, 2) + pow(p1.y - p2.y, 2));
-}
+// the points as separate coordinate arrays, so the distance kernel can
+// load several of them at once
+struct point_set {
+    int n;
+    int32_t *x;
+    int32_t *y;
+};
 
-// compare two edges based on their weights for sorting
-int compare_edges(const void *a, const void *b) {
-    return ((struct edge*)a)->weight > ((struct edge*)b)->weight ? 1 : -1;
-}
+// node of the k-d tree over points[lo .. hi - 1] of the tree order,
+// component is -1 unless all of its points are in the same component
+struct kd_node {
+    int lo;
+    int hi;
+    int left;
+    int right;
+    int min_x, max_x, min_y, max_y;
+    int component;
+};
 
-// find the parent of a vertex (used in disjoint set union)
-int find_parent(int parent[], int vertex) {
-    if (parent[vertex] == -1)
-        return vertex;
-    return find_parent(parent, parent[vertex]);
-}
+// k-d tree with the points in tree order, nodes[0] is the root
+struct kd_tree {
+    struct point *points;
+    int *index;
+    struct kd_node *nodes;
+    int node_count;
+};
 
-// "union" sets basically by changing their parent
-void union_sets(int parent[], int x, int y) {
-    int root_x = find_parent(parent, x);
-    int root_y = find_parent(parent, y);
-    parent[root_x] = root_y;
+// weighted edge list read with --edges, vertices are 0-based
+struct edge_list {
+    int n;
+    int m;
+    int *u;
+    int *v;
+    double *w;
+};
+
+// one parallel boruvka round on the k-d tree: the points of component
+// k of this round are order[start[k] .. start[k + 1] - 1] and its root
+// is roots[k], threads take whole components so they never share a
+// candidate
+struct geometric_round {
+    struct kd_tree *T;
+    int *component;
+    int *order;
+    int *start;
+    int *roots;
+    int root_count;
+    struct candidate *best;
+    atomic_int next;
+};
+
+// one parallel boruvka round on an edge list: best[c] is the index of
+// the lightest edge leaving component c, lowered with compare-and-swap.
+// thread t scans alive[first[t] .. first[t] + alive_count[t] - 1] and
+// drops the edges that became internal to a component
+struct edge_round {
+    struct edge_list *E;
+    int *component;
+    atomic_int *best;
+    int *alive;
+    long long *first;
+    long long *alive_count;
+};
+
+// argument of a thread: the shared round and the thread index
+struct round_worker {
+    void *round;
+    int id;
+};
+
+// lightest edge found so far out of a component, ties broken by
+// vertex indices so that boruvka never picks the edges of a cycle
+struct candidate {
+    long long d2;
+    int u;
+    int v;
+};
+
+// squared distances from (xi, yi) to the points x[0 .. count - 1],
+// y[0 .. count - 1]. coordinates up to 10^9 in absolute value keep the
+// differences within int32 and the sums within 63 bits, so all of it is
+// exact integer arithmetic
+void squared_distances(const int32_t *x, const int32_t *y, int32_t xi, int32_t yi, int count, uint64_t *out) {
+    int j = 0;
+#if defined(__AVX2__)
+    // four points per step: widen to 64-bit lanes, _mm256_mul_epi32
+    // squares the low 32 bits of each lane into 64 bits
+    __m256i vxi = _mm256_set1_epi64x(xi);
+    __m256i vyi = _mm256_set1_epi64x(yi);
+    for (; j + 4 <= count; j += 4) {
+        __m256i vx = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(x + j)));
+        __m256i vy = _mm256_cvtepi32_epi64(_mm_loadu_si128((const __m128i *)(y + j)));
+        __m256i dx = _mm256_sub_epi64(vx, vxi);
+        __m256i dy = _mm256_sub_epi64(vy, vyi);
+        __m256i d2 = _mm256_add_epi64(_mm256_mul_epi32(dx, dx), _mm256_mul_epi32(dy, dy));
+        _mm256_storeu_si256((__m256i *)(out + j), d2);
+    }
+#elif defined(__SSE4_1__)
+    // two points per step, same scheme on 128-bit registers
+    __m128i vxi = _mm_set1_epi64x(xi);
+    __m128i vyi = _mm_set1_epi64x(yi);
+    for (; j + 2 <= count; j += 2) {
+        __m128i vx = _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)(x + j)));
+        __m128i vy = _mm_cvtepi32_epi64(_mm_loadl_epi64((const __m128i *)(y + j)));
+        __m128i dx = _mm_sub_epi64(vx, vxi);
+        __m128i dy = _mm_sub_epi64(vy, vyi);
+        __m128i d2 = _mm_add_epi64(_mm_mul_epi32(dx, dx), _mm_mul_epi32(dy, dy));
+        _mm_storeu_si128((__m128i *)(out + j), d2);
+    }
+#endif
+    for (; j < count; j++) {
+        int64_t dx = (int64_t)x[j] - xi;
+        int64_t dy = (int64_t)y[j] - yi;
+        out[j] = (uint64_t)(dx * dx + dy * dy);
+    }
 }
 
 // generate all possible edges between points
-void generate_edges(struct point points[], struct edge edges[], int n)
+void generate_edges(struct point_set *P, struct edge edges[])
 {
-    int edge_index = 0;
-    for (int i = 0; i < n; ++i) {
-        for (int j = i + 1; j < n; ++j) {
+    uint64_t *row = malloc((P->n > 0 ? P->n : 1) * sizeof(uint64_t));
+    long long edge_index = 0;
+    for (int i = 0; i < P->n; ++i) {
+        int count = P->n - i - 1;
+        squared_distances(P->x + i + 1, P->y + i + 1, P->x[i], P->y[i], count, row);
+        for (int j = 0; j < count; ++j) {
             edges[edge_index].src = i;
-            edges[edge_index].dest = j;
-            edges[edge_index].weight = distance(points[i], points[j]);
+            edges[edge_index].dest = i + 1 + j;
+            edges[edge_index].d2 = row[j];
             edge_index++;
         }
     }
+    free(row);
+}
+
+// LSD radix sort on the squared lengths, one byte per pass. the passes
+// where every key has the same byte are skipped, small coordinates need
+// only the low three or four bytes
+void radix_sort_edges(struct edge edges[], long long count) {
+    struct edge *buffer = malloc((count > 0 ? count : 1) * sizeof(struct edge));
+    struct edge *from = edges, *to = buffer;
+    for (int shift = 0; shift < 64; shift += 8) {
+        long long histogram[256] = {0};
+        for (long long i = 0; i < count; i++) {
+            histogram[(from[i].d2 >> shift) & 0xff]++;
+        }
+        if (count == 0 || histogram[(from[0].d2 >> shift) & 0xff] == count)
+            continue;
+
+        long long offset = 0;
+        for (int b = 0; b < 256; b++) {
+            long long c = histogram[b];
+            histogram[b] = offset;
+            offset += c;
+        }
+        for (long long i = 0; i < count; i++) {
+            to[histogram[(from[i].d2 >> shift) & 0xff]++] = from[i];
+        }
+        struct edge *t = from;
+        from = to;
+        to = t;
+    }
+    if (from != edges)
+        memcpy(edges, from, count * sizeof(struct edge));
+    free(buffer);
 }
 
 // Kruskal's algorithm to find the minimum spanning tree
 double kruskal_mst(struct point points[], int n) {
-    int num_edges = n * (n - 1) / 2;
+    long long num_edges = (long long)n * (n - 1) / 2;
 
-    struct edge edges[num_edges];
-    generate_edges(points, edges, n);
+    // structure of arrays copy of the points for the distance kernel
+    struct point_set P;
+    P.n = n;
+    P.x = malloc((n > 0 ? n : 1) * sizeof(int32_t));
+    P.y = malloc((n > 0 ? n : 1) * sizeof(int32_t));
+    for (int i = 0; i < n; i++) {
+        P.x[i] = points[i].x;
+        P.y[i] = points[i].y;
+    }
+
+    struct edge *edges = malloc((num_edges > 0 ? num_edges : 1) * sizeof(struct edge));
+    generate_edges(&P, edges);
+    free(P.x);
+    free(P.y);
 
     // sort the edges in non-decreasing order of weight
-    qsort(edges, num_edges, sizeof(struct edge), compare_edges);
+    radix_sort_edges(edges, num_edges);
     
-    // initialize parent array to keep track of parent of each vertex (disjoint set), -1 means root
-    int parent[n];
-    for (int i = 0; i < n; i++) {
-        parent[i] = -1;
-    }
+    // disjoint sets of the vertices joined so far
+    struct union_find *U = uf_create(n);
     
     double total_length = 0.0;
     
     // iterate through the sorted edges and add them to the MST
-    for (int i = 0; i < num_edges; i++) {
+    for (long long i = 0; i < num_edges; i++) {
         int src = edges[i].src;
         int dest = edges[i].dest;
-        double weight = edges[i].weight;
         
-        // check if including this edge forms a cycle in MST
-        if (find_parent(parent, src) != find_parent(parent, dest)) {
-            // add the edge in MST
-            total_length += weight;
-            union_sets(parent, src, dest);
+        // add the edge in MST unless it forms a cycle, only the tree
+        // edges need the square root
+        if (uf_union(U, src, dest)) {
+            total_length += sqrt((double)edges[i].d2);
         }
     }
     
+    free(edges);
+    uf_free(U);
     return total_length;
 }
 
-int main() {
-    int n;
-    scanf("%d", &n);
-    
-    struct point points[n];
-    
+// squared distance, exact for coordinates up to 10^9 in absolute value
+long long squared_distance(struct point p1, struct point p2) {
+    long long dx = p1.x - (long long)p2.x;
+    long long dy = p1.y - (long long)p2.y;
+    return dx * dx + dy * dy;
+}
+
+int compare_keys(const void *a, const void *b) {
+    long long x = *(const long long *)a, y = *(const long long *)b;
+    return (x > y) - (x < y);
+}
+
+// sum of the tree edges given by their squared lengths. every minimum
+// spanning tree has the same sorted edge lengths, and summing them in
+// increasing order like kruskal_mst() gives the same bits
+double tree_length(long long keys[], int count) {
+    qsort(keys, count, sizeof(long long), compare_keys);
+    double total_length = 0.0;
+    for (int i = 0; i < count; i++) {
+        total_length += sqrt((double)keys[i]);
+    }
+    return total_length;
+}
+
+// Prim's algorithm on the complete graph, distances are computed when
+// needed so only O(n) memory is used
+double prim_mst(struct point points[], int n) {
+    long long *best = malloc(n * sizeof(long long));
+    bool *in_tree = calloc(n, sizeof(bool));
+    long long *keys = malloc(n * sizeof(long long));
+    int key_count = 0;
+
     for (int i = 0; i < n; i++) {
-        scanf("%d %d", &points[i].x, &points[i].y);
+        best[i] = LLONG_MAX;
+    }
+    int u = 0;
+    for (int k = 0; k < n; k++) {
+        in_tree[u] = true;
+        if (k > 0)
+            keys[key_count++] = best[u];
+
+        // update the distances to the tree and find the closest vertex
+        int next = -1;
+        for (int v = 0; v < n; v++) {
+            if (in_tree[v])
+                continue;
+            long long d2 = squared_distance(points[u], points[v]);
+            if (d2 < best[v])
+                best[v] = d2;
+            if (next == -1 || best[v] < best[next])
+                next = v;
+        }
+        u = next;
+    }
+
+    double total_length = tree_length(keys, key_count);
+    free(best);
+    free(in_tree);
+    free(keys);
+    return total_length;
+}
+
+// coordinate of a point along the axis (0: x, 1: y)
+int coordinate(struct point p, int axis) {
+    return axis == 0 ? p.x : p.y;
+}
+
+// puts the k-th smallest point along the axis at index k of points[lo .. hi - 1]
+void select_point(struct point points[], int index[], int lo, int hi, int k, int axis) {
+    while (hi - lo > 1) {
+        int pivot = coordinate(points[lo + (hi - lo) / 2], axis);
+        int i = lo, j = hi - 1;
+        while (i <= j) {
+            while (coordinate(points[i], axis) < pivot)
+                i++;
+            while (coordinate(points[j], axis) > pivot)
+                j--;
+            if (i <= j) {
+                struct point p = points[i];
+                points[i] = points[j];
+                points[j] = p;
+                int t = index[i];
+                index[i] = index[j];
+                index[j] = t;
+                i++;
+                j--;
+            }
+        }
+        if (k <= j)
+            hi = j + 1;
+        else if (k >= i)
+            lo = i;
+        else
+            return;
+    }
+}
+
+// builds the subtree over points[lo .. hi - 1], returns its node
+int build_kd_tree(struct kd_tree *T, int lo, int hi) {
+    int id = T->node_count++;
+    struct kd_node *node = &T->nodes[id];
+    node->lo = lo;
+    node->hi = hi;
+    node->left = node->right = -1;
+    node->min_x = node->min_y = INT_MAX;
+    node->max_x = node->max_y = INT_MIN;
+    for (int i = lo; i < hi; i++) {
+        struct point p = T->points[i];
+        if (p.x < node->min_x) node->min_x = p.x;
+        if (p.x > node->max_x) node->max_x = p.x;
+        if (p.y < node->min_y) node->min_y = p.y;
+        if (p.y > node->max_y) node->max_y = p.y;
+    }
+    if (hi - lo <= KD_LEAF_SIZE)
+        return id;
+
+    // split the wider side at the median
+    int axis = (long long)node->max_x - node->min_x >= (long long)node->max_y - node->min_y ? 0 : 1;
+    int mid = lo + (hi - lo) / 2;
+    select_point(T->points, T->index, lo, hi, mid, axis);
+    int left = build_kd_tree(T, lo, mid);
+    int right = build_kd_tree(T, mid, hi);
+    T->nodes[id].left = left;
+    T->nodes[id].right = right;
+    return id;
+}
+
+// squared distance from a point to the bounding box of a node
+long long box_distance(struct kd_node *node, struct point p) {
+    long long dx = 0, dy = 0;
+    if (p.x < node->min_x) dx = node->min_x - (long long)p.x;
+    else if (p.x > node->max_x) dx = p.x - (long long)node->max_x;
+    if (p.y < node->min_y) dy = node->min_y - (long long)p.y;
+    else if (p.y > node->max_y) dy = p.y - (long long)node->max_y;
+    return dx * dx + dy * dy;
+}
+
+// true if the edge (d2, u, v) is lighter than the candidate
+bool lighter(long long d2, int u, int v, struct candidate *c) {
+    if (d2 != c->d2)
+        return d2 < c->d2;
+    int a = u < v ? u : v, b = u < v ? v : u;
+    int ca = c->u < c->v ? c->u : c->v, cb = c->u < c->v ? c->v : c->u;
+    return a < ca || (a == ca && b < cb);
+}
+
+// marks each node with the component of its points, or -1 if mixed
+int label_components(struct kd_tree *T, int id, int component[]) {
+    struct kd_node *node = &T->nodes[id];
+    if (node->left == -1) {
+        int c = component[node->lo];
+        for (int i = node->lo + 1; i < node->hi && c != -1; i++) {
+            if (component[i] != c)
+                c = -1;
+        }
+        node->component = c;
+    } else {
+        int l = label_components(T, node->left, component);
+        int r = label_components(T, node->right, component);
+        node->component = l == r ? l : -1;
+    }
+    return node->component;
+}
+
+// lightest edge from point i (tree order) to another component
+void nearest_outside(struct kd_tree *T, int id, int i, int component[], struct candidate *best) {
+    struct kd_node *node = &T->nodes[id];
+    if (node->component == component[i])
+        return;
+    if (box_distance(node, T->points[i]) > best->d2)
+        return;
+    if (node->left == -1) {
+        for (int j = node->lo; j < node->hi; j++) {
+            if (component[j] == component[i])
+                continue;
+            long long d2 = squared_distance(T->points[i], T->points[j]);
+            if (lighter(d2, T->index[i], T->index[j], best)) {
+                best->d2 = d2;
+                best->u = T->index[i];
+                best->v = T->index[j];
+            }
+        }
+        return;
+    }
+
+    // the child closer to the point first
+    int first = node->left, second = node->right;
+    if (box_distance(&T->nodes[second], T->points[i]) < box_distance(&T->nodes[first], T->points[i])) {
+        first = node->right;
+        second = node->left;
+    }
+    nearest_outside(T, first, i, component, best);
+    nearest_outside(T, second, i, component, best);
+}
+
+// runs fn on thread_count threads, the calling thread being thread 0
+void run_threads(void *(*fn)(void *), void *round) {
+    pthread_t *threads = malloc(thread_count * sizeof(pthread_t));
+    struct round_worker *workers = malloc(thread_count * sizeof(struct round_worker));
+    for (int t = 0; t < thread_count; t++) {
+        workers[t].round = round;
+        workers[t].id = t;
+    }
+    for (int t = 1; t < thread_count; t++) {
+        pthread_create(&threads[t], NULL, fn, &workers[t]);
+    }
+    fn(&workers[0]);
+    for (int t = 1; t < thread_count; t++) {
+        pthread_join(threads[t], NULL);
+    }
+    free(threads);
+    free(workers);
+}
+
+// searches the lightest edge out of the components it takes
+void *geometric_worker(void *arg) {
+    struct geometric_round *R = ((struct round_worker *)arg)->round;
+    int k;
+    while ((k = atomic_fetch_add(&R->next, 1)) < R->root_count) {
+        struct candidate c = {LLONG_MAX, INT_MAX, INT_MAX};
+        for (int i = R->start[k]; i < R->start[k + 1]; i++) {
+            nearest_outside(R->T, 0, R->order[i], R->component, &c);
+        }
+        R->best[R->roots[k]] = c;
+    }
+    return NULL;
+}
+
+// Euclidean MST with Boruvka's algorithm on a k-d tree: in each round,
+// every point looks for its nearest point in another component, skipping
+// the subtrees inside its own component and the ones farther than the
+// lightest edge its component has so far, then every component takes
+// its lightest edge. The number of components at least halves per round.
+// The components of a round are searched in parallel, a thread takes a
+// whole component at a time.
+double emst(struct point input[], int n) {
+    struct kd_tree T;
+    T.points = malloc(n * sizeof(struct point));
+    T.index = malloc(n * sizeof(int));
+    // leaves hold at least KD_LEAF_SIZE / 2 points, so there are at most
+    // n / 2 nodes
+    T.nodes = malloc((n / 2 + 2) * sizeof(struct kd_node));
+    T.node_count = 0;
+    memcpy(T.points, input, n * sizeof(struct point));
+    for (int i = 0; i < n; i++) {
+        T.index[i] = i;
+    }
+    if (n > 0)
+        build_kd_tree(&T, 0, n);
+
+    // sets of input vertices, component of each point in tree order
+    struct union_find *U = uf_create(n);
+    int *component = malloc(n * sizeof(int));
+    int *order = malloc(n * sizeof(int));
+    int *start = malloc((n + 1) * sizeof(int));
+    int *roots = malloc(n * sizeof(int));
+    int *slot = malloc(n * sizeof(int));
+    struct candidate *best = malloc(n * sizeof(struct candidate));
+    long long *keys = malloc(n * sizeof(long long));
+    int key_count = 0;
+
+    struct geometric_round R;
+    R.T = &T;
+    R.component = component;
+    R.order = order;
+    R.start = start;
+    R.roots = roots;
+    R.best = best;
+
+    while (key_count < n - 1) {
+        // group the points by component, slot[] maps a root to its group
+        R.root_count = 0;
+        for (int i = 0; i < n; i++) {
+            component[i] = uf_find(U, T.index[i]);
+            if (component[i] == T.index[i]) {
+                slot[component[i]] = R.root_count;
+                roots[R.root_count++] = component[i];
+            }
+        }
+        memset(start, 0, (R.root_count + 1) * sizeof(int));
+        for (int i = 0; i < n; i++) {
+            start[slot[component[i]] + 1]++;
+        }
+        for (int k = 0; k < R.root_count; k++) {
+            start[k + 1] += start[k];
+        }
+        for (int i = 0; i < n; i++) {
+            order[start[slot[component[i]]]++] = i;
+        }
+        for (int k = R.root_count; k > 0; k--) {
+            start[k] = start[k - 1];
+        }
+        start[0] = 0;
+        label_components(&T, 0, component);
+
+        // best[] is indexed by the input vertex of the component root
+        atomic_init(&R.next, 0);
+        run_threads(geometric_worker, &R);
+        for (int k = 0; k < R.root_count; k++) {
+            struct candidate *c = &best[roots[k]];
+            if (c->d2 != LLONG_MAX && uf_union(U, c->u, c->v))
+                keys[key_count++] = c->d2;
+        }
+    }
+
+    double total_length = tree_length(keys, key_count);
+    free(T.points);
+    free(T.index);
+    free(T.nodes);
+    uf_free(U);
+    free(component);
+    free(order);
+    free(start);
+    free(roots);
+    free(slot);
+    free(best);
+    free(keys);
+    return total_length;
+}
+
+// offers edge e as the lightest edge out of a component, ties are
+// broken by index so all threads agree on one edge
+void offer_edge(atomic_int *best, int e, const double *w) {
+    int current = atomic_load_explicit(best, memory_order_relaxed);
+    while (current == -1 || w[e] < w[current] || (w[e] == w[current] && e < current)) {
+        if (atomic_compare_exchange_weak_explicit(best, &current, e, memory_order_relaxed, memory_order_relaxed))
+            return;
+    }
+}
+
+// scans the alive edges of its range
+void *edge_worker(void *arg) {
+    struct round_worker *W = arg;
+    struct edge_round *R = W->round;
+    struct edge_list *E = R->E;
+    int *alive = R->alive + R->first[W->id];
+    long long kept = 0;
+    for (long long i = 0; i < R->alive_count[W->id]; i++) {
+        int e = alive[i];
+        int cu = R->component[E->u[e]];
+        int cv = R->component[E->v[e]];
+        if (cu == cv)
+            continue;
+        alive[kept++] = e;
+        offer_edge(&R->best[cu], e, E->w);
+        offer_edge(&R->best[cv], e, E->w);
+    }
+    R->alive_count[W->id] = kept;
+    return NULL;
+}
+
+int compare_weights(const void *a, const void *b) {
+    double x = *(const double *)a, y = *(const double *)b;
+    return (x > y) - (x < y);
+}
+
+// parallel Boruvka's algorithm on an explicit edge list, the total
+// weight of a minimum spanning forest. the chosen weights are summed in
+// increasing order so the result does not depend on the thread count
+double edge_list_mst(struct edge_list *E) {
+    struct union_find *U = uf_create(E->n);
+    struct edge_round R;
+    R.E = E;
+    R.component = malloc((E->n > 0 ? E->n : 1) * sizeof(int));
+    R.best = malloc((E->n > 0 ? E->n : 1) * sizeof(atomic_int));
+    R.alive = malloc((E->m > 0 ? E->m : 1) * sizeof(int));
+    R.first = malloc(thread_count * sizeof(long long));
+    R.alive_count = malloc(thread_count * sizeof(long long));
+    for (int e = 0; e < E->m; e++) {
+        R.alive[e] = e;
+    }
+    for (int t = 0; t < thread_count; t++) {
+        R.first[t] = (long long)E->m * t / thread_count;
+        R.alive_count[t] = (long long)E->m * (t + 1) / thread_count - R.first[t];
+    }
+    double *weights = malloc((E->n > 0 ? E->n : 1) * sizeof(double));
+    int weight_count = 0;
+
+    for (bool merged = true; merged; ) {
+        for (int v = 0; v < E->n; v++) {
+            R.component[v] = uf_find(U, v);
+            atomic_init(&R.best[v], -1);
+        }
+        run_threads(edge_worker, &R);
+
+        merged = false;
+        for (int v = 0; v < E->n; v++) {
+            int e = atomic_load(&R.best[v]);
+            if (e != -1 && uf_union(U, E->u[e], E->v[e])) {
+                weights[weight_count++] = E->w[e];
+                merged = true;
+            }
+        }
+    }
+
+    qsort(weights, weight_count, sizeof(double), compare_weights);
+    double total_weight = 0.0;
+    for (int i = 0; i < weight_count; i++) {
+        total_weight += weights[i];
+    }
+    uf_free(U);
+    free(R.component);
+    free(R.best);
+    free(R.alive);
+    free(R.first);
+    free(R.alive_count);
+    free(weights);
+    return total_weight;
+}
+
+// usage: ./a.out [--prim | --emst | --edges] [--threads=<t>] [--time] < input
+//     --prim         dense Prim's algorithm, O(n^2) time and O(n) memory
+//     --emst         Boruvka's algorithm on a k-d tree, for large inputs
+//     --edges        the input is "n m" and m lines "u v w" (1-based),
+//                    prints the weight of a minimum spanning forest
+//     --threads=<t>  threads for --emst and --edges
+//     --time         print the time of the mst to stderr
+int main(int argc, char *argv[]) {
+    double (*mst)(struct point[], int) = kruskal_mst;
+    bool edges = false;
+    bool print_time = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--prim") == 0) {
+            mst = prim_mst;
+        } else if (strcmp(argv[i], "--emst") == 0) {
+            mst = emst;
+        } else if (strcmp(argv[i], "--edges") == 0) {
+            edges = true;
+        } else if (strncmp(argv[i], "--threads=", 10) == 0) {
+            thread_count = atoi(argv[i] + 10);
+            if (thread_count < 1) {
+                fprintf(stderr, "invalid thread count: %s\n", argv[i] + 10);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--time") == 0) {
+            print_time = true;
+        } else {
+            fprintf(stderr, "unknown option: %s\n", argv[i]);
+            return 1;
+        }
+    }
+
+    struct timespec start, end;
+    double total_length;
+    if (edges) {
+        struct edge_list E;
+        scanf("%d %d", &E.n, &E.m);
+        E.u = malloc((E.m > 0 ? E.m : 1) * sizeof(int));
+        E.v = malloc((E.m > 0 ? E.m : 1) * sizeof(int));
+        E.w = malloc((E.m > 0 ? E.m : 1) * sizeof(double));
+        for (int i = 0; i < E.m; i++) {
+            scanf("%d %d %lf", &E.u[i], &E.v[i], &E.w[i]);
+            E.u[i]--;
+            E.v[i]--;
+        }
+
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        total_length = edge_list_mst(&E);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free(E.u);
+        free(E.v);
+        free(E.w);
+    } else {
+        int n;
+        scanf("%d", &n);
+        
+        struct point *points = malloc(n * sizeof(struct point));
+        
+        for (int i = 0; i < n; i++) {
+            scanf("%d %d", &points[i].x, &points[i].y);
+        }
+        
+        clock_gettime(CLOCK_MONOTONIC, &start);
+        total_length = mst(points, n);
+        clock_gettime(CLOCK_MONOTONIC, &end);
+        free(points);
     }
-    
-    double total_length = kruskal_mst(points, n);
     printf("%.9f\n", total_length);
+    if (print_time) {
+        fprintf(stderr, "%d threads: %.3f ms\n", thread_count,
+                (end.tv_sec - start.tv_sec) * 1e3 + (end.tv_nsec - start.tv_nsec) / 1e6);
+    }
     
     return 0;
 }
@@ -0,0 +1,55 @@
+#!/bin/bash
+
+# usage: ./bench_connecting_points.sh [max_threads]
+max_threads=${1:-$(nproc)}
+
+# compile the C code with optimizations and the host's vector units
+gcc -pipe -O2 -march=native -std=c11 -pthread ../../../week-5/connecting_points.c -Wall -lm -o bench.out &&
+
+# n random points in [-r, r]^2
+generate_points() {
+    awk -v n="$1" -v r="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n
+        for (i = 0; i < n; ++i) {
+            print int((2 * rand() - 1) * r), int((2 * rand() - 1) * r)
+        }
+    }'
+}
+
+# n vertices, m random edges with weights in [0, 100)
+generate_edges() {
+    awk -v n="$1" -v m="$2" -v seed="$3" 'BEGIN {
+        srand(seed)
+        print n, m
+        for (i = 0; i < m; ++i) {
+            printf "%d %d %.3f\n", int(n * rand()) + 1, int(n * rand()) + 1, 100 * rand()
+        }
+    }'
+}
+
+tmp_dir=$(mktemp -d)
+
+# the complete graph of a few thousand points with every mode
+generate_points 4000 1000000 1 > "$tmp_dir/small"
+echo "$(head -n 1 "$tmp_dir/small") points"
+for mode in "" --prim --emst
+do
+    echo "    ${mode:-kruskal}: $(./bench.out $mode --time < "$tmp_dir/small" 2>&1 >/dev/null)"
+done
+
+generate_points 1000000 1000000000 2 > "$tmp_dir/points"
+echo "$(head -n 1 "$tmp_dir/points") points, --emst"
+for (( t = 1; t <= max_threads; ++t ))
+do
+    ./bench.out --emst --threads=$t --time < "$tmp_dir/points" 2>&1 >/dev/null | sed 's/^/    /'
+done
+
+generate_edges 1000000 5000000 3 > "$tmp_dir/edges"
+echo "edge list: $(head -n 1 "$tmp_dir/edges"), --edges"
+for (( t = 1; t <= max_threads; ++t ))
+do
+    ./bench.out --edges --threads=$t --time < "$tmp_dir/edges" 2>&1 >/dev/null | sed 's/^/    /'
+done
+
+rm -rf "$tmp_dir" bench.out
@@ -0,0 +1,62 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../union_find.h"
+
+// keeps the finds from being optimized away
+static volatile int sink;
+
+// the disjoint sets connecting_points.c used before union_find.h:
+// recursive find without compression, roots linked in argument order
+int find_parent(int parent[], int vertex) {
+    if (parent[vertex] == -1)
+        return vertex;
+    return find_parent(parent, parent[vertex]);
+}
+
+void union_sets(int parent[], int x, int y) {
+    int root_x = find_parent(parent, x);
+    int root_y = find_parent(parent, y);
+    parent[root_x] = root_y;
+}
+
+// adversarial order for the naive sets: union(i, i + 1) hangs the whole
+// chain 0 -> 1 -> ... -> i under i + 1, and find(0) then walks all of it
+double naive_chain(int n) {
+    int *parent = malloc(n * sizeof(int));
+    for (int i = 0; i < n; i++) {
+        parent[i] = -1;
+    }
+    clock_t start = clock();
+    for (int i = 0; i + 1 < n; i++) {
+        union_sets(parent, i, i + 1);
+        sink = find_parent(parent, 0);
+    }
+    clock_t end = clock();
+    free(parent);
+    return (double)(end - start) / CLOCKS_PER_SEC * 1000;
+}
+
+double uf_chain(int n) {
+    struct union_find *U = uf_create(n);
+    clock_t start = clock();
+    for (int i = 0; i + 1 < n; i++) {
+        uf_union(U, i, i + 1);
+        sink = uf_find(U, 0);
+    }
+    clock_t end = clock();
+    uf_free(U);
+    return (double)(end - start) / CLOCKS_PER_SEC * 1000;
+}
+
+// usage: ./a.out <n>... runs both on the chain order for every n
+int main(int argc, char *argv[]) {
+    printf("%10s %16s %16s\n", "n", "naive (ms)", "union_find (ms)");
+    for (int i = 1; i < argc; i++) {
+        int n = atoi(argv[i]);
+        double naive = naive_chain(n);
+        double fast = uf_chain(n);
+        printf("%10d %16.3f %16.3f\n", n, naive, fast);
+    }
+    return 0;
+}
@@ -0,0 +1,10 @@
+#!/bin/bash
+
+# compile the microbenchmark with optimizations
+gcc -pipe -O2 -std=c11 bench_union_find.c -Wall -lm -o bench.out &&
+
+# the naive sets are quadratic on the chain order, union_find.h stays
+# close to linear
+./bench.out 1000 3000 10000 30000 100000
+
+rm -f bench.out
@@ -0,0 +1,68 @@
+#ifndef UNION_FIND_H
+#define UNION_FIND_H
+
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+
+// disjoint sets over the vertices 0 .. n - 1 in one flat int32 array:
+// parent[v] >= 0 is the parent of v, parent[v] < 0 marks a root whose
+// set has -parent[v] vertices
+struct union_find {
+    int32_t n;
+    int32_t *parent;
+};
+
+// n singleton sets
+static inline struct union_find *uf_create(int32_t n) {
+    struct union_find *U = malloc(sizeof(struct union_find));
+    U->n = n;
+    U->parent = malloc((n > 0 ? n : 1) * sizeof(int32_t));
+    for (int32_t i = 0; i < n; i++) {
+        U->parent[i] = -1;
+    }
+    return U;
+}
+
+static inline void uf_free(struct union_find *U) {
+    free(U->parent);
+    free(U);
+}
+
+// root of the set of v, iterative with path halving: every visited
+// vertex is linked to its grandparent, which keeps the trees flat
+// without a second pass or recursion
+static inline int32_t uf_find(struct union_find *U, int32_t v) {
+    int32_t *parent = U->parent;
+    while (parent[v] >= 0) {
+        if (parent[parent[v]] >= 0)
+            parent[v] = parent[parent[v]];
+        v = parent[v];
+    }
+    return v;
+}
+
+// number of vertices in the set of v
+static inline int32_t uf_size(struct union_find *U, int32_t v) {
+    return -U->parent[uf_find(U, v)];
+}
+
+// merges the sets of a and b, the smaller set goes under the root of the
+// larger one so a find never walks more than log2(n) links. returns
+// false if a and b were already in the same set
+static inline bool uf_union(struct union_find *U, int32_t a, int32_t b) {
+    int32_t root_a = uf_find(U, a);
+    int32_t root_b = uf_find(U, b);
+    if (root_a == root_b)
+        return false;
+    if (U->parent[root_a] > U->parent[root_b]) {
+        int32_t t = root_a;
+        root_a = root_b;
+        root_b = t;
+    }
+    U->parent[root_a] += U->parent[root_b];
+    U->parent[root_b] = root_a;
+    return true;
+}
+
+#endif /* UNION_FIND_H */